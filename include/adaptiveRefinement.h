@@ -0,0 +1,32 @@
+#ifndef ADAPTIVE_REFINEMENT_H
+#define ADAPTIVE_REFINEMENT_H
+#include <opencv2/opencv.hpp>
+
+// Tuning for confidence-guided refinement
+struct AdaptiveRefinementParams {
+    int blockSize = 32;                  // confidence / work granularity in pixels
+    int margin = 16;                     // context added around a block for the refinement pass
+    float consistencyThreshold = 1.0f;   // forward/backward disagreement (px) counted as inconsistent
+    float minConsistentFraction = 0.9f;  // blocks below this fraction of consistent pixels are refined
+    float maxResidual = 12.0f;           // blocks above this mean warp residual (gray levels) are refined
+    int numThreads = 0;                  // refinement workers, 0 = cv::getNumThreads()
+};
+
+// What the adaptive pass did
+struct AdaptiveRefinementStats {
+    cv::Mat blockConfidence;  // CV_32FC1, one value in [0, 1] per block
+    cv::Mat blockRefined;     // CV_8UC1, 255 for blocks that went through the refinement pass
+    int totalBlocks = 0;
+    int refinedBlocks = 0;
+};
+
+// Cheap symmetric flow everywhere, expensive flow + bilateral regularization only on
+// blocks whose forward/backward consistency or warp residual marks them unreliable.
+// vs      : output symmetric flow (CV_32FC2)
+// occMask : output consistency mask (CV_32FC1, 1.0 = visible)
+bool computeSymmetricFlowAdaptive(const cv::Mat& I0, const cv::Mat& I1,
+                                  cv::Mat& vs, cv::Mat& occMask,
+                                  const AdaptiveRefinementParams& params = AdaptiveRefinementParams(),
+                                  AdaptiveRefinementStats* stats = nullptr);
+
+#endif // ADAPTIVE_REFINEMENT_H
@@ -0,0 +1,39 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+#include <string>
+#include <vector>
+#include "threadScheduler.h"
+
+// One unit of work in a shard manifest
+struct ShardJob {
+    std::string frame0;
+    std::string frame1;
+    std::string groundTruth;
+    std::string label;
+};
+
+// Manifest format, one job per line (relative paths are relative to the manifest):
+//   <dataset dir>                              Middlebury layout: <dir>/frame10.png, <dir>/frame11.png,
+//                                              ground truth in <dir>/../../ground_truth/<name>/frame10i11.png
+//   <frame0> <frame1> <ground truth> [label]   explicit frame pair
+// Blank lines and lines starting with '#' are ignored.
+bool readShardManifest(const std::string& manifestPath, std::vector<ShardJob>& jobs);
+
+// Claim and run jobs until every job in the manifest has a result under workDir.
+// Claims are lock files created with O_EXCL in <workDir>/claims; a worker refreshes its
+// lease while running and other workers break leases not refreshed for leaseSeconds
+// (by renaming them to a private tombstone and re-checking it). Results are written to
+// <workDir>/results/job<N>.tsv by atomic rename. Unreadable inputs are retried a few
+// times before the job is recorded as failed; a result that cannot be written fails the worker.
+// scheduling.workers processes (default one per NUMA node) claim jobs independently, each
+// pinned to its share of the thread budget with an OpenCV pool of that size; a utilization
+// and NUMA traffic report is printed to stderr at the end. Returns 1 if a worker fails.
+int runShardWorker(const std::string& manifestPath, const std::string& workDir, int leaseSeconds = 600,
+                   const SchedulerConfig& scheduling = SchedulerConfig());
+
+// Combine per-job results into the metrics table (stdout and <workDir>/results.txt).
+// Returns non-zero if any job has no result yet, its result records a failure, or a
+// result row is malformed (such rows are skipped and reported on stderr).
+int mergeShardResults(const std::string& manifestPath, const std::string& workDir);
+
+#endif // BATCH_RUNNER_H
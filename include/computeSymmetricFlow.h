@@ -1,6 +1,7 @@
 #ifndef COMPUTE_SYMMETRIC_FLOW_H
 #define COMPUTE_SYMMETRIC_FLOW_H
 #include <opencv2/opencv.hpp>
+#include "frameFeatures.h"
 
 // Computes symmetric flow to midpoint using TVL1
 bool computeSymmetricFlowTVL1(const cv::Mat& I0, const cv::Mat& I1, cv::Mat& vs);
@@ -8,4 +9,16 @@ bool computeSymmetricFlowTVL1(const cv::Mat& I0, const cv::Mat& I1, cv::Mat& vs)
 // Compute symmetric flow v_s between I0 and I1 using Farnebäck optical flow.
 bool computeSymmetricFlowFarneback(const cv::Mat& I0, const cv::Mat& I1, cv::Mat& vs);
 
+// Same, reusing each frame's precomputed grayscale image
+bool computeSymmetricFlowFarneback(const FrameFeatures& f0, const FrameFeatures& f1, cv::Mat& vs);
+
+// Coarse-to-fine symmetric flow solved directly at the midpoint: one pyramid pass
+// matching I0(x - v) to I1(x + v), instead of combining forward and backward flows.
+bool computeSymmetricFlowMidpoint(const cv::Mat& I0, const cv::Mat& I1, cv::Mat& vs,
+                                  int levels = 4, int winSize = 15, int iterations = 3);
+
+// Same, reusing each frame's precomputed pyramid and warp planes
+bool computeSymmetricFlowMidpoint(const FrameFeatures& f0, const FrameFeatures& f1, cv::Mat& vs,
+                                  int winSize = 15, int iterations = 3);
+
 #endif // COMPUTE_SYMMETRIC_FLOW_H
\ No newline at end of file
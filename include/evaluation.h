@@ -0,0 +1,36 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+#include <opencv2/opencv.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Compute Mean Absolute Interpolation Error
+double computeMAIE(const cv::Mat& pred, const cv::Mat& gt);
+
+// Compute Peak Signal-to-Noise Ratio
+double computePSNR(const cv::Mat& pred, const cv::Mat& gt);
+
+// Compute Structural Similarity Index (SSIM)
+double computeSSIM(const cv::Mat& pred, const cv::Mat& gt);
+
+// One line of the results table
+struct MetricsRow {
+    std::string label;
+    double maie = 0.0;
+    double psnr = 0.0;
+    double ssim = 0.0;
+    std::string note;  // optional extra line (timings), printed indented below the row
+};
+
+// Run every interpolation variant on one frame pair, save the frames under outDir
+// and score them against the ground-truth midpoint. Returns false if flow fails.
+bool evaluatePair(const cv::Mat& I0, const cv::Mat& I1, const cv::Mat& gt,
+                  const std::string& label, const std::string& outDir,
+                  std::vector<MetricsRow>& rows);
+
+// Table formatting shared by the batch and shard runners
+void printMetricsHeader(std::ostream& os);
+void printMetricsRow(std::ostream& os, const MetricsRow& row);
+
+#endif // EVALUATION_H
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef FRAME_FEATURES_H
+#define FRAME_FEATURES_H
+#include <opencv2/opencv.hpp>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Per-frame preprocessing shared by every pair the frame takes part in.
+// In a sequence each interior frame is I1 of (N-1, N) and I0 of (N, N+1).
+struct FrameFeatures {
+    cv::Mat gray;                     // CV_8UC1, input to Farneback
+    cv::Mat guide;                    // CV_32FC1, joint bilateral guide and pyramid base
+    std::vector<cv::Mat> pyramid;     // CV_32FC1 levels of guide, finest first
+    std::vector<cv::Mat> warpPlanes;  // per level [I, Ix, Iy] (CV_32FC3) for the midpoint estimator
+};
+
+// Build features for one frame (CV_8UC3 or CV_8UC1)
+// levels : pyramid levels (coarsest kept >= 16 px), <= 0 for grayscale and guide only
+std::shared_ptr<const FrameFeatures> computeFrameFeatures(const cv::Mat& frame, int levels = 4);
+
+// Stack intensity and its gradients into one CV_32FC3 plane ([I, Ix, Iy])
+void buildWarpPlane(const cv::Mat& level, cv::Mat& plane);
+
+// Features keyed by frame index, computed on first request and evicted after
+// usesPerFrame requests. Callers keep entries alive through the shared_ptr.
+// The first request computes outside the lock; concurrent requests for the same
+// index wait for that result, requests for other indices do not.
+class FrameFeatureCache {
+public:
+    explicit FrameFeatureCache(int levels = 4, int usesPerFrame = 2);
+
+    std::shared_ptr<const FrameFeatures> acquire(int index, const cv::Mat& frame);
+
+    // Drop an entry early, e.g. the first frame of a sequence which is only used once
+    void evict(int index);
+
+    size_t size() const;
+
+    // Number of times features were computed, i.e. cache misses
+    size_t computed() const;
+
+private:
+    struct Entry {
+        std::shared_future<std::shared_ptr<const FrameFeatures>> features;
+        int remainingUses;
+    };
+
+    int levels_;
+    int usesPerFrame_;
+    size_t computed_ = 0;
+    std::map<int, Entry> entries_;
+    mutable std::mutex mutex_;
+};
+
+#endif // FRAME_FEATURES_H
@@ -0,0 +1,75 @@
+#ifndef INTERPOLATOR_H
+#define INTERPOLATOR_H
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include "warpUtils.h"
+
+// Stages run by an Interpolator session
+enum class InterpolationPipeline {
+    Raw,            // Farneback symmetric flow, plain symmetric warp
+    Regularized     // + joint bilateral regularization and occlusion-aware warp
+};
+
+// Fixed for the lifetime of a session
+struct InterpolatorConfig {
+    cv::Size size;                                        // frame size every call must match
+    InterpolationPipeline pipeline = InterpolationPipeline::Regularized;
+    WarpPrecision precision = WarpPrecision::Float;
+    OcclusionFallback occlusionFallback = OcclusionFallback::Fill;  // Regularized only
+    float occlusionThreshold = 1.0f;                      // forward/backward disagreement in px
+    int regularizationDiameter = 5;
+    double sigmaColor = 20.0;
+    double sigmaSpace = 20.0;
+};
+
+// Stateful midpoint interpolation for one resolution and pipeline.
+// Every session buffer (grayscale frames, flows, mask, scratch) is allocated in the
+// constructor and reused, and outputs are written into caller-provided Mats, so
+// per-frame calls do not allocate in this library. OpenCV's Farneback and bilateral
+// filter still manage their own internal temporaries.
+// The constructor zero-fills the buffers, placing them on the constructing thread's
+// NUMA node: build sessions inside a pinned ThreadScheduler worker, not before run().
+class Interpolator {
+public:
+    explicit Interpolator(const InterpolatorConfig& config);
+    ~Interpolator();
+
+    Interpolator(Interpolator&&) noexcept;
+    Interpolator& operator=(Interpolator&&) noexcept;
+    Interpolator(const Interpolator&) = delete;
+    Interpolator& operator=(const Interpolator&) = delete;
+
+    const InterpolatorConfig& config() const;
+
+    // Midpoint of (I0, I1), both CV_8UC3 at config().size. out is reused when it is
+    // already CV_8UC3 of that size. Returns false on mismatched inputs.
+    bool interpolate(const cv::Mat& I0, const cv::Mat& I1, cv::Mat& out);
+
+    // Streaming: feed consecutive frames; from the second frame on, writes the midpoint
+    // of (previous, frame) into out and returns true. The previous frame's grayscale
+    // conversion is reused rather than recomputed, and each frame is copied once into a
+    // preallocated two-slot ring, so the caller may overwrite frame after the call. Stream state is separate from
+    // interpolate(), so the two can be mixed on one session.
+    bool interpolateNext(const cv::Mat& frame, cv::Mat& out);
+
+    // Forget the previous streaming frame
+    void resetStream();
+
+    // Symmetric flow (CV_32FC2) and consistency mask (CV_32FC1) of the last call;
+    // the mask is only filled by the Regularized pipeline
+    const cv::Mat& flow() const;
+    // Symmetric flow of the last call before regularization (equal to flow() for Raw)
+    const cv::Mat& rawFlow() const;
+    const cv::Mat& occlusionMask() const;
+
+private:
+    struct State;
+
+    // Run the configured stages; gray0 and gray1 are the grayscale versions of I0 and I1
+    void runPipeline(const cv::Mat& gray0, const cv::Mat& gray1,
+                     const cv::Mat& I0, const cv::Mat& I1, cv::Mat& out);
+
+    std::unique_ptr<State> state_;
+};
+
+#endif // INTERPOLATOR_H
@@ -1,11 +1,18 @@
 #ifndef OCCLUSION_HANDLING_H
 #define OCCLUSION_HANDLING_H
 #include <opencv2/opencv.hpp>
+#include "frameFeatures.h"
 
 // PERFORM OCCLUSION HANDLING DURING INTERPOLATION
 cv::Mat computeOcclusionMask(const cv::Mat &flowFwd, const cv::Mat &flowBwd, float threshold = 1.0f);
 
+// Same, writing into a caller-owned CV_32FC1 mask
+void computeOcclusionMask(const cv::Mat &flowFwd, const cv::Mat &flowBwd, cv::Mat &mask, float threshold = 1.0f);
+
 // Convenience: compute forward/backward Farneback flows internally and return consistency mask
 cv::Mat computeOcclusionMaskFarneback(const cv::Mat& I0, const cv::Mat& I1, float threshold = 1.0f);
 
+// Same, reusing each frame's precomputed grayscale image
+cv::Mat computeOcclusionMaskFarneback(const FrameFeatures& f0, const FrameFeatures& f1, float threshold = 1.0f);
+
 #endif // OCCLUSION_HANDLING_H
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef SEQUENCE_INTERPOLATION_H
+#define SEQUENCE_INTERPOLATION_H
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "frameFeatures.h"
+
+// Midpoints of every consecutive pair of a sequence (e.g. frame07 .. frame14).
+// Each interior frame is I1 of one pair and I0 of the next; its grayscale, guide,
+// pyramid and warp planes come from the cache and are computed once, not twice.
+// Flow is the midpoint estimator, regularized with the I0 guide.
+// frames : CV_8UC3 frames of equal size, in display order
+// mids   : output, mids[i] is the midpoint of frames[i] and frames[i + 1]
+// cache  : levels > 0 and usesPerFrame 2; left empty on success
+// returns : false if the sequence is too short or flow fails
+bool interpolateSequence(const std::vector<cv::Mat>& frames, std::vector<cv::Mat>& mids,
+                         FrameFeatureCache& cache);
+
+#endif // SEQUENCE_INTERPOLATION_H
\ No newline at end of file
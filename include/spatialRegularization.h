@@ -6,4 +6,8 @@
 void jointBilateralRegularization(const cv::Mat &guide, cv::Mat &flow,
                                   int d = 5, double sigmaColor = 20.0, double sigmaSpace = 20.0);
 
+// Same, with caller-owned scratch for the two flow channels
+void jointBilateralRegularization(const cv::Mat &guide, cv::Mat &flow, std::vector<cv::Mat> &channels,
+                                  int d = 5, double sigmaColor = 20.0, double sigmaSpace = 20.0);
+
 #endif // SPATIAL_REGULARIZATION_H
\ No newline at end of file
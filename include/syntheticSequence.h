@@ -0,0 +1,50 @@
+#ifndef SYNTHETIC_SEQUENCE_H
+#define SYNTHETIC_SEQUENCE_H
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+
+// Motion model of a synthetic pair
+enum class SyntheticMotion {
+    Translation,  // textured plane translating by `magnitude` px along a fixed diagonal
+    Rotation,     // textured plane rotating by `magnitude` degrees about the frame centre
+    Occlusion     // textured square translating over a background moving the opposite way
+};
+
+struct SyntheticParams {
+    cv::Size size = cv::Size(1920, 1080);
+    SyntheticMotion motion = SyntheticMotion::Translation;
+    float magnitude = 16.0f;  // total motion between I0 and I1 (px, or degrees for Rotation)
+    uint32_t seed = 1;        // texture seed; equal params give identical output
+    int pairIndex = 0;        // pair k of a sequence spans t = k .. k + 1, so I1 of pair k is I0 of pair k + 1
+};
+
+// Frames at t = k, k + 0.5, k + 1 (k = pairIndex) rendered from an analytic texture, plus exact ground truth.
+// For Rotation the symmetric flow is the chord average 0.5 * (p1 - p0) of the arc.
+struct SyntheticPair {
+    cv::Mat I0, I1;   // CV_8UC3
+    cv::Mat mid;      // CV_8UC3 true frame at t = 0.5
+    cv::Mat flowTo0;  // CV_32FC2, p0 - x: where mid(x) comes from in I0
+    cv::Mat flowTo1;  // CV_32FC2, p1 - x: where mid(x) goes to in I1
+    cv::Mat flowMid;  // CV_32FC2, symmetric flow 0.5 * (flowTo1 - flowTo0)
+    cv::Mat visible;  // CV_8UC1, 255 where the mid pixel is visible in both I0 and I1
+};
+
+// Render a deterministic synthetic pair
+void generateSyntheticPair(const SyntheticParams& params, SyntheticPair& pair);
+
+// Parse "WxH" or one of 720p, 1080p, 4k, 8k
+bool parseSyntheticSize(const std::string& text, cv::Size& size);
+
+// Parse translation | rotation | occlusion
+bool parseSyntheticMotion(const std::string& text, SyntheticMotion& motion);
+
+const char* syntheticMotionName(SyntheticMotion motion);
+
+// Mean endpoint error of flow against gt over pixels where mask is non-zero (all if empty)
+double computeEndpointError(const cv::Mat& flow, const cv::Mat& gt, const cv::Mat& mask = cv::Mat());
+
+// Write a CV_32FC2 flow field in the Middlebury .flo format
+bool writeFlowFile(const std::string& path, const cv::Mat& flow);
+
+#endif // SYNTHETIC_SEQUENCE_H
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef THREAD_SCHEDULER_H
+#define THREAD_SCHEDULER_H
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// CPUs this process may run on, grouped by NUMA node
+struct CpuTopology {
+    std::vector<int> nodeIds;             // NUMA node number of each group
+    std::vector<std::vector<int>> cpus;   // allowed CPUs per node, in sysfs cpulist order
+
+    int cpuCount() const;
+};
+
+// Read /sys/devices/system/node/node*/cpulist and intersect with the affinity mask.
+// Falls back to a single node of hardware_concurrency CPUs when sysfs is unavailable.
+CpuTopology detectCpuTopology();
+
+// Parse a kernel cpulist such as "0-3,8,10-11"
+bool parseCpuList(const std::string& text, std::vector<int>& cpus);
+
+// Thread budget for one process
+struct SchedulerConfig {
+    int threadBudget = 0;  // CPUs used in total, 0 = every allowed CPU
+    int workers = 0;       // worker processes, 0 = one per NUMA node the budget covers
+    bool pin = true;       // bind workers to their CPUs (Linux only)
+};
+
+// Where a worker runs
+struct WorkerPlacement {
+    int node = 0;             // NUMA node of the worker's first CPU
+    std::vector<int> cpus;    // CPUs the worker is pinned to; also its OpenCV thread count
+};
+
+// Per-worker measurements of one run
+struct WorkerReport {
+    int node = 0;
+    std::vector<int> cpus;
+    bool completed = false;        // the worker process exited with status 0 (the body returned >= 0)
+    int units = 0;                 // value returned by the worker body, e.g. jobs completed
+    double wallSeconds = 0.0;
+    double cpuSeconds = 0.0;       // user + system time of all the worker's threads
+    bool countersValid = false;    // perf counters could be opened
+    uint64_t nodeLoads = 0;        // loads that reached memory (perf node-loads)
+    uint64_t remoteNodeLoads = 0;  // of those, served by another node (perf node-load-misses)
+};
+
+struct SchedulerReport {
+    int nodes = 0;
+    int threadBudget = 0;
+    double wallSeconds = 0.0;
+    std::vector<WorkerReport> workers;
+
+    bool allCompleted() const;
+};
+
+// Utilization is CPU time over wall time times CPUs; remote share is node-load-misses over node-loads
+void printSchedulerReport(std::ostream& os, const SchedulerReport& report);
+
+// Owns the thread budget of a process. The budget is taken node by node from the
+// topology and split into one CPU range per worker; with the default of one worker
+// per node, each worker gets exactly one node's share of the budget.
+//
+// Every worker is a child process pinned to its range before the body runs, with
+// cv::setNumThreads(range size). OpenCV's thread pool is per process, so each worker
+// has its own pool of exactly its share: nested parallelism inside Farneback and the
+// bilateral filter uses every budgeted CPU without oversubscribing, and pool threads
+// inherit the worker's CPU mask. Frames and session buffers the body allocates are
+// first touched, and placed by the kernel, on the worker's node.
+//
+// As workers are processes, the body's results must leave through files or stdout,
+// as the shard runner's do; only the returned unit count is passed back. fork() only
+// copies the calling thread, so run() must be called before the process has started
+// any thread, including OpenCV's pool (the first parallel cv:: call starts it); run()
+// asserts this.
+class ThreadScheduler {
+public:
+    explicit ThreadScheduler(const SchedulerConfig& config = SchedulerConfig());
+
+    const CpuTopology& topology() const { return topology_; }
+    const std::vector<WorkerPlacement>& placements() const { return placements_; }
+    int threadBudget() const { return budget_; }
+
+    // Run body(worker) once in every worker process and wait for all of them.
+    // The body returns the number of units it processed, for the report, or a
+    // negative value on failure, which the worker passes on as exit status 1.
+    SchedulerReport run(const std::function<int(int worker)>& body);
+
+private:
+    // In the worker process: pin, size OpenCV's pool, run the body
+    int runWorker(int worker, const std::function<int(int worker)>& body) const;
+
+    CpuTopology topology_;
+    std::vector<WorkerPlacement> placements_;
+    bool pin_;
+    int budget_;
+};
+
+#endif // THREAD_SCHEDULER_H
\ No newline at end of file
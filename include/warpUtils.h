@@ -2,16 +2,71 @@
 #define WARP_UTILS_H
 #include <opencv2/opencv.hpp>
 
+// Arithmetic used by the 8-bit warp
+enum class WarpPrecision {
+    Float,   // float bilinear weights and blending (reference path)
+    FixedQ8  // Q8 integer weights, 16-bit accumulation on packed RGB lanes
+};
+
+// Maximum per-channel difference between the FixedQ8 and Float paths.
+// Q8 weight quantization moves a sample by < 2 levels from exact bilinear,
+// the Float path's per-row Vec3b rounding by <= 1, and both round the result,
+// so samples differ by at most 3. The midpoint average truncates identically.
+constexpr int kFixedWarpMaxError = 3;
+
+// What interpolateSymmetricWithOcclusion writes where the mask marks a pixel occluded
+enum class OcclusionFallback {
+    Fill,       // background flow of the span's visible neighbours, sampled from one side
+    ZeroMotion  // average of I0 and I1 at the pixel itself; ghosts on moving edges
+};
+
 // Bilinear sampling from RGB image at floating ccordinates
 bool sampleFrameBilinear(const cv::Mat& frame, float x, float y, cv::Vec3b& outPixel);
 
+// Fixed-point bilinear sampling (Q8 weights), same bounds rule as sampleFrameBilinear
+bool sampleFrameBilinearFixed(const cv::Mat& frame, float x, float y, cv::Vec3b& outPixel);
+
 // Interpolate mid-point frame using symmetric flow
-cv::Mat interpolateSymmetric(const cv::Mat& I0, const cv::Mat& I1, const cv::Mat& vs);
+cv::Mat interpolateSymmetric(const cv::Mat& I0, const cv::Mat& I1, const cv::Mat& vs,
+                             WarpPrecision precision = WarpPrecision::Float);
 
-// Occlusion-aware interpolation: use mask to reduce blending where flows are inconsistent
+// Same, writing into I_mid (reused when it is already CV_8UC3 of the right size)
+void interpolateSymmetric(const cv::Mat& I0, const cv::Mat& I1, const cv::Mat& vs,
+                          cv::Mat& I_mid, WarpPrecision precision = WarpPrecision::Float);
+
+// Occlusion-aware interpolation: use mask to reduce blending where flows are inconsistent.
+// The warp scan collects the occluded spans of each row; only those pixels are filled,
+// so the fill costs time proportional to the number of occluded pixels.
 cv::Mat interpolateSymmetricWithOcclusion(const cv::Mat& I0,
 										  const cv::Mat& I1,
 										  const cv::Mat& vs,
-										  const cv::Mat& occMask);
+										  const cv::Mat& occMask,
+										  WarpPrecision precision = WarpPrecision::Float,
+										  OcclusionFallback fallback = OcclusionFallback::Fill);
+
+// Same, writing into I_mid (reused when it is already CV_8UC3 of the right size)
+void interpolateSymmetricWithOcclusion(const cv::Mat& I0,
+									   const cv::Mat& I1,
+									   const cv::Mat& vs,
+									   const cv::Mat& occMask,
+									   cv::Mat& I_mid,
+									   WarpPrecision precision = WarpPrecision::Float,
+									   OcclusionFallback fallback = OcclusionFallback::Fill);
+
+// Batched interpolation: synthesize frames at several times t in (0, 1) from one
+// symmetric flow in a single pass. Flow, mask and fallback reads are shared across
+// all outputs; outFrames is resized to ts.size() and CV_8UC3 buffers of the right
+// size are written in place. Pass an empty occMask to skip occlusion handling;
+// otherwise occluded pixels are filled as by OcclusionFallback::Fill, from occluded
+// spans collected once per row and shared by every t.
+// vs and occMask live on the t = 0.5 grid; for other t the flow at x is used as the
+// flow at time t, which is exact for locally constant motion and an approximation
+// near motion boundaries and under acceleration (t = 0.5 is exact).
+void interpolateSymmetricMulti(const cv::Mat& I0,
+                               const cv::Mat& I1,
+                               const cv::Mat& vs,
+                               const cv::Mat& occMask,
+                               const std::vector<float>& ts,
+                               std::vector<cv::Mat>& outFrames);
 
 #endif // WARP_UTILS_H
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "adaptiveRefinement.h"
+#include "occlusionHandling.h"
+#include "spatialRegularization.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+using namespace cv;
+
+// Symmetric flow and consistency mask from a forward/backward Farneback pair
+// g0, g1  : grayscale frames (CV_8UC1)
+// quality : false = fast settings for the first pass, true = settings used on refined blocks
+static void symmetricFlowAndMask(const Mat& g0, const Mat& g1, bool quality, float threshold,
+                                 Mat& vs, Mat& mask)
+{
+    const int    winsize    = quality ? 21 : 9;
+    const int    iterations = quality ? 5 : 1;
+    const int    polyN      = quality ? 7 : 5;
+    const double polySigma  = quality ? 1.5 : 1.1;
+
+    Mat flowFwd, flowBwd;
+    calcOpticalFlowFarneback(g0, g1, flowFwd, 0.5, 3, winsize, iterations, polyN, polySigma, 0);
+    calcOpticalFlowFarneback(g1, g0, flowBwd, 0.5, 3, winsize, iterations, polyN, polySigma, 0);
+
+    // v_s(x) = 0.5 * (v_f(x) - v_b(x))
+    vs = 0.5 * (flowFwd - flowBwd);
+    mask = computeOcclusionMask(flowFwd, flowBwd, threshold);
+}
+
+// Absolute residual |I1(x + vs) - I0(x - vs)| on the grayscale frames
+static Mat warpResidual(const Mat& g0, const Mat& g1, const Mat& vs)
+{
+    Mat map0(vs.size(), CV_32FC2), map1(vs.size(), CV_32FC2);
+    parallel_for_(Range(0, vs.rows), [&](const Range& r) {
+        for (int y = r.start; y < r.end; ++y) {
+            const Point2f* pv = vs.ptr<Point2f>(y);
+            Point2f* m0 = map0.ptr<Point2f>(y);
+            Point2f* m1 = map1.ptr<Point2f>(y);
+            for (int x = 0; x < vs.cols; ++x) {
+                m0[x] = Point2f(x - pv[x].x, y - pv[x].y);
+                m1[x] = Point2f(x + pv[x].x, y + pv[x].y);
+            }
+        }
+    });
+
+    Mat w0, w1, residual;
+    remap(g0, w0, map0, noArray(), INTER_LINEAR, BORDER_REPLICATE);
+    remap(g1, w1, map1, noArray(), INTER_LINEAR, BORDER_REPLICATE);
+    absdiff(w0, w1, residual);
+    residual.convertTo(residual, CV_32F);
+    return residual;
+}
+
+// Confidence-guided symmetric flow
+// I0, I1  : input frames (CV_8UC3 or CV_8UC1), same size
+// vs      : output symmetric flow field (CV_32FC2)
+// occMask : output consistency mask (CV_32FC1, 1.0 = visible, 0.0 = occluded)
+// params  : block size, thresholds and worker count
+// stats   : optional per-block confidence and refinement counts
+// returns : true on success
+bool computeSymmetricFlowAdaptive(const Mat& I0, const Mat& I1,
+                                  Mat& vs, Mat& occMask,
+                                  const AdaptiveRefinementParams& params,
+                                  AdaptiveRefinementStats* stats)
+{
+    if (I0.empty() || I1.empty()) {
+        std::cerr << "Error: one or both input frames are empty.\n";
+        return false;
+    }
+
+    if (I0.size() != I1.size()) {
+        std::cerr << "Error: input frames must have the same size.\n";
+        return false;
+    }
+
+    CV_Assert(params.blockSize > 0 && params.margin >= 0 && params.maxResidual > 0.0f);
+
+    Mat g0, g1;
+    if (I0.channels() == 3) cvtColor(I0, g0, COLOR_BGR2GRAY); else g0 = I0;
+    if (I1.channels() == 3) cvtColor(I1, g1, COLOR_BGR2GRAY); else g1 = I1;
+
+    // Cheap pass over the whole frame
+    symmetricFlowAndMask(g0, g1, false, params.consistencyThreshold, vs, occMask);
+    Mat residual = warpResidual(g0, g1, vs);
+
+    // Block confidence from consistency and residual; collect unreliable blocks
+    const int bs = params.blockSize;
+    const int bx = (I0.cols + bs - 1) / bs;
+    const int by = (I0.rows + bs - 1) / bs;
+    Mat confidence(by, bx, CV_32FC1);
+    Mat refined(by, bx, CV_8UC1, Scalar(0));
+    std::vector<Rect> queue;
+
+    for (int j = 0; j < by; ++j) {
+        for (int i = 0; i < bx; ++i) {
+            Rect block = Rect(i * bs, j * bs, bs, bs) & Rect(0, 0, I0.cols, I0.rows);
+            float consistent = static_cast<float>(mean(occMask(block))[0]);
+            float meanResidual = static_cast<float>(mean(residual(block))[0]);
+
+            confidence.at<float>(j, i) =
+                std::clamp(std::min(consistent, 1.0f - meanResidual / params.maxResidual), 0.0f, 1.0f);
+
+            if (consistent < params.minConsistentFraction || meanResidual > params.maxResidual) {
+                queue.push_back(block);
+                refined.at<uchar>(j, i) = 255;
+            }
+        }
+    }
+
+    // Refine queued blocks; workers pull from a shared index and write disjoint block interiors
+    const Rect frame(0, 0, I0.cols, I0.rows);
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t n = next++; n < queue.size(); n = next++) {
+            const Rect& block = queue[n];
+            Rect roi = Rect(block.x - params.margin, block.y - params.margin,
+                            block.width + 2 * params.margin, block.height + 2 * params.margin) & frame;
+
+            Mat vsRoi, maskRoi;
+            symmetricFlowAndMask(g0(roi), g1(roi), true, params.consistencyThreshold, vsRoi, maskRoi);
+            jointBilateralRegularization(g0(roi), vsRoi, 7, 20.0, 20.0);
+
+            const Rect inner(block.x - roi.x, block.y - roi.y, block.width, block.height);
+            vsRoi(inner).copyTo(vs(block));
+            maskRoi(inner).copyTo(occMask(block));
+        }
+    };
+
+    // Default to OpenCV's thread count, which a ThreadScheduler sets to this worker's share
+    int numThreads = params.numThreads > 0 ? params.numThreads : getNumThreads();
+    numThreads = std::max(1, std::min(numThreads, static_cast<int>(queue.size())));
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < numThreads; ++t)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers)
+        w.join();
+
+    if (stats) {
+        stats->blockConfidence = confidence;
+        stats->blockRefined = refined;
+        stats->totalBlocks = bx * by;
+        stats->refinedBlocks = static_cast<int>(queue.size());
+    }
+    return true;
+}
@@ -0,0 +1,415 @@
+#include "batchRunner.h"
+#include "evaluation.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// Parse the job manifest
+// manifestPath : text file, one job per line (see batchRunner.h)
+// jobs         : output jobs in manifest order; the index is the job id
+// returns      : false if the manifest cannot be read or a line is malformed
+bool readShardManifest(const std::string& manifestPath, std::vector<ShardJob>& jobs) {
+    std::ifstream in(manifestPath);
+    if (!in) {
+        std::cerr << "Error: could not open manifest " << manifestPath << std::endl;
+        return false;
+    }
+
+    const fs::path base = fs::absolute(manifestPath).parent_path();
+    auto resolve = [&](const std::string& p) { return (base / p).lexically_normal().string(); };
+
+    jobs.clear();
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        std::istringstream tokens(line);
+        std::vector<std::string> fields;
+        for (std::string t; tokens >> t;) fields.push_back(t);
+        if (fields.empty() || fields[0][0] == '#') continue;
+
+        ShardJob job;
+        if (fields.size() == 1) {
+            fs::path dir = fs::path(resolve(fields[0]));
+            // "eval_data/Urban2/" (e.g. from ls -d */) has an empty filename
+            if (dir.filename().empty()) dir = dir.parent_path();
+            std::string name = dir.filename().string();
+            job.frame0 = (dir / "frame10.png").string();
+            job.frame1 = (dir / "frame11.png").string();
+            job.groundTruth = (dir.parent_path().parent_path() / "ground_truth" / name / "frame10i11.png").string();
+            job.label = name;
+        } else if (fields.size() == 3 || fields.size() == 4) {
+            job.frame0 = resolve(fields[0]);
+            job.frame1 = resolve(fields[1]);
+            job.groundTruth = resolve(fields[2]);
+            job.label = fields.size() == 4 ? fields[3] : fs::path(job.frame0).parent_path().filename().string();
+        } else {
+            std::cerr << "Error: " << manifestPath << ":" << lineNo
+                      << ": expected a dataset directory or '<frame0> <frame1> <ground truth> [label]'" << std::endl;
+            return false;
+        }
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+static fs::path leasePath(const fs::path& workDir, size_t index) {
+    return workDir / "claims" / ("job" + std::to_string(index) + ".lease");
+}
+
+static fs::path resultPath(const fs::path& workDir, size_t index) {
+    return workDir / "results" / ("job" + std::to_string(index) + ".tsv");
+}
+
+// host.pid, unique across workers sharing the filesystem
+static std::string workerId() {
+    char host[256] = {0};
+    gethostname(host, sizeof(host) - 1);
+    return std::string(host) + "." + std::to_string(getpid());
+}
+
+// Atomically create the lease file; fails if another worker holds it
+static bool tryCreateLease(const fs::path& lease, const std::string& owner) {
+    int fd = ::open(lease.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) return false;
+    std::string content = owner + "\n";
+    if (::write(fd, content.data(), content.size()) < 0)
+        std::cerr << "Warning: could not record owner in " << lease << std::endl;
+    ::close(fd);
+    return true;
+}
+
+// First line of a lease file, the owner that created it
+static std::string readLeaseOwner(const fs::path& lease) {
+    std::ifstream in(lease);
+    std::string holder;
+    std::getline(in, holder);
+    return holder;
+}
+
+// Owner and last refresh of a lease, as seen by one worker
+struct LeaseState {
+    std::string holder;
+    time_t mtime = 0;
+};
+
+// A lease has expired when its holder stopped refreshing it for leaseSeconds
+// state : filled with the holder and mtime the decision was based on
+static bool leaseExpired(const fs::path& lease, int leaseSeconds, LeaseState& state) {
+    struct stat st;
+    if (::stat(lease.c_str(), &st) != 0) return false;
+    state.mtime = st.st_mtime;
+    state.holder = readLeaseOwner(lease);
+    return std::time(nullptr) - st.st_mtime > leaseSeconds;
+}
+
+// Break an expired lease. The expiry check and the break are not one step: between
+// them the holder may refresh it, or another worker may break it and claim the job
+// with a fresh lease under the same name. So the lease is first renamed to a
+// tombstone only this worker uses, then the tombstone is checked against the state
+// that was judged expired. If it changed, the moved lease belongs to a live worker
+// and is put back with link(), which fails rather than replace a newer lease.
+// expired : holder and mtime seen by leaseExpired
+static bool breakLease(const fs::path& lease, const std::string& owner, const LeaseState& expired) {
+    fs::path tombstone = lease;
+    tombstone += ".stale." + owner;
+    if (::rename(lease.c_str(), tombstone.c_str()) != 0) return false;
+
+    struct stat st;
+    const bool unchanged = ::stat(tombstone.c_str(), &st) == 0 && st.st_mtime == expired.mtime &&
+                           readLeaseOwner(tombstone) == expired.holder;
+    if (!unchanged && ::link(tombstone.c_str(), lease.c_str()) != 0)
+        std::cerr << owner << ": could not restore live lease " << lease << std::endl;
+    ::unlink(tombstone.c_str());
+    return unchanged;
+}
+
+// Remove the lease only while it still records this worker as owner; after a
+// stall it may have been broken and re-claimed, and that lease is not ours
+static void releaseLease(const fs::path& lease, const std::string& owner) {
+    if (readLeaseOwner(lease) != owner) return;
+    ::unlink(lease.c_str());
+}
+
+// Keeps a lease alive by touching it every leaseSeconds / 3 while a job runs.
+// Stops for good once the lease no longer records owner: it was broken after a
+// stall, and touching it would keep another worker's lease alive.
+class LeaseHeartbeat {
+public:
+    LeaseHeartbeat(const fs::path& lease, const std::string& owner, int leaseSeconds)
+        : thread_([this, lease, owner, leaseSeconds] {
+              const auto period = std::chrono::seconds(std::max(1, leaseSeconds / 3));
+              std::unique_lock<std::mutex> lock(mutex_);
+              while (!cv_.wait_for(lock, period, [this] { return stop_; })) {
+                  if (readLeaseOwner(lease) != owner) {
+                      std::cerr << owner << ": lost lease " << lease << ", no longer refreshing it" << std::endl;
+                      break;
+                  }
+                  ::utimensat(AT_FDCWD, lease.c_str(), nullptr, 0);
+              }
+          }) {}
+
+    ~LeaseHeartbeat() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+// Input reads are retried this many times per worker before the job is recorded as failed
+static const int kMaxReadAttempts = 3;
+
+// Publish a job's rows (or failure note) by atomic rename
+// returns : false if the temporary file could not be written or renamed
+static bool publishResult(const fs::path& workDir, size_t index, const std::string& owner,
+                          const std::string& content) {
+    fs::path result = resultPath(workDir, index);
+    fs::path tmp = result;
+    tmp += ".tmp." + owner;
+
+    std::ofstream file(tmp);
+    file << content;
+    file.close();
+    std::error_code ec;
+    if (!file.good()) {
+        std::cerr << owner << ": could not write " << tmp << std::endl;
+        fs::remove(tmp, ec);
+        return false;
+    }
+    fs::rename(tmp, result, ec);
+    if (ec) {
+        std::cerr << owner << ": could not publish " << result << ": " << ec.message() << std::endl;
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+// Outcome of one runJob call
+enum class JobOutcome {
+    Published,  // a result (rows or a failure note) is in results/
+    Retry,      // inputs unreadable, retry on a later pass
+    Failed      // the result could not be written; this worker gives up on the job
+};
+
+// Run one job and publish its rows. Unreadable inputs may be transient (e.g. files
+// still being copied to shared storage), so they are not published until the last
+// attempt; a failed evaluation is deterministic and is published at once. Failure
+// results start with "# failed" and make the merge step report an error.
+// attempt : 1-based read attempt of this worker for the job
+static JobOutcome runJob(const ShardJob& job, const fs::path& workDir, size_t index, const std::string& owner,
+                   int attempt) {
+    std::ostringstream out;
+
+    cv::Mat I0 = cv::imread(job.frame0);
+    cv::Mat I1 = cv::imread(job.frame1);
+    cv::Mat gt = cv::imread(job.groundTruth);
+    std::vector<MetricsRow> rows;
+    if (I0.empty() || I1.empty() || gt.empty()) {
+        if (attempt < kMaxReadAttempts) {
+            std::cerr << owner << ": could not read inputs of job " << index << " (" << job.label
+                      << "), attempt " << attempt << " of " << kMaxReadAttempts << std::endl;
+            return JobOutcome::Retry;
+        }
+        out << "# failed: could not read input images\n";
+    } else {
+        std::string outDir = (workDir / "interpolated" / job.label).string() + "/";
+        std::error_code ec;
+        fs::create_directories(outDir, ec);
+        if (!evaluatePair(I0, I1, gt, job.label, outDir, rows))
+            out << "# failed: flow computation\n";
+    }
+
+    out.precision(17);
+    for (const MetricsRow& row : rows)
+        out << row.label << '\t' << row.maie << '\t' << row.psnr << '\t' << row.ssim << '\t' << row.note << '\n';
+
+    return publishResult(workDir, index, owner, out.str()) ? JobOutcome::Published : JobOutcome::Failed;
+}
+
+// Claim and run jobs until none is pending
+// owner   : unique claim owner, one per worker
+// returns : number of jobs this worker completed, or -1 if it could not publish a result
+static int claimJobs(const std::vector<ShardJob>& jobs, const fs::path& root, const std::string& owner,
+                     int leaseSeconds) {
+    int completed = 0;
+    std::map<size_t, int> readAttempts;
+    std::set<size_t> unpublished;
+
+    while (true) {
+        size_t pending = 0;
+        bool ranJob = false;
+
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (unpublished.count(i) || fs::exists(resultPath(root, i))) continue;
+            ++pending;
+
+            const fs::path lease = leasePath(root, i);
+            if (!tryCreateLease(lease, owner)) {
+                LeaseState expired;
+                if (!leaseExpired(lease, leaseSeconds, expired) || !breakLease(lease, owner, expired) ||
+                    !tryCreateLease(lease, owner))
+                    continue;
+                std::cerr << owner << ": reclaimed expired job " << i << " (" << jobs[i].label << ")" << std::endl;
+            }
+
+            // The previous holder may have published just before its lease was broken
+            JobOutcome outcome = JobOutcome::Published;
+            if (!fs::exists(resultPath(root, i))) {
+                LeaseHeartbeat heartbeat(lease, owner, leaseSeconds);
+                outcome = runJob(jobs[i], root, i, owner, ++readAttempts[i]);
+                if (outcome == JobOutcome::Published) ++completed;
+                if (outcome == JobOutcome::Failed) unpublished.insert(i);
+            }
+            releaseLease(lease, owner);
+            ranJob = ranJob || outcome != JobOutcome::Retry;
+        }
+
+        if (pending == 0) break;
+        // Everything left is held by live workers or waiting for a read retry;
+        // wait for results, expired leases or the inputs to appear
+        if (!ranJob) std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    if (!unpublished.empty()) {
+        std::cerr << owner << ": could not publish " << unpublished.size() << " job(s)" << std::endl;
+        return -1;
+    }
+    return completed;
+}
+
+// Shard worker loop
+// manifestPath : job manifest shared by all workers
+// workDir      : shared directory holding claims/, results/ and interpolated/
+// leaseSeconds : a claim not refreshed for this long is reclaimed by other workers
+// scheduling   : thread budget and in-process workers; each worker claims jobs on its own
+// returns      : process exit code
+int runShardWorker(const std::string& manifestPath, const std::string& workDir, int leaseSeconds,
+                   const SchedulerConfig& scheduling) {
+    std::vector<ShardJob> jobs;
+    if (!readShardManifest(manifestPath, jobs)) return 1;
+
+    const fs::path root(workDir);
+    std::error_code ec;
+    fs::create_directories(root / "claims", ec);
+    fs::create_directories(root / "results", ec);
+    if (ec) {
+        std::cerr << "Error: could not create work directory " << workDir << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    const std::string owner = workerId();
+
+    // Jobs are read and evaluated in the pinned worker processes, so their buffers live on the worker's node
+    ThreadScheduler scheduler(scheduling);
+    SchedulerReport report = scheduler.run([&](int worker) {
+        return claimJobs(jobs, root, owner + ".w" + std::to_string(worker), leaseSeconds);
+    });
+
+    // A worker that could not publish returns -1 and is reported as not completed
+    int completed = 0;
+    for (const WorkerReport& r : report.workers) completed += std::max(0, r.units);
+    std::cerr << owner << ": completed " << completed << " job(s)" << std::endl;
+    printSchedulerReport(std::cerr, report);
+    return report.allCompleted() ? 0 : 1;
+}
+
+// Parse a whole field as a double; std::stod would throw on a truncated row
+static bool parseMetric(const std::string& field, double& value) {
+    if (field.empty()) return false;
+    char* end = nullptr;
+    value = std::strtod(field.c_str(), &end);
+    return end == field.c_str() + field.size();
+}
+
+// Merge per-job results in manifest order. Malformed rows (e.g. a result file
+// truncated by a full disk) are skipped and reported.
+// returns : 0 when every job has a successful, well-formed result, 1 otherwise
+int mergeShardResults(const std::string& manifestPath, const std::string& workDir) {
+    std::vector<ShardJob> jobs;
+    if (!readShardManifest(manifestPath, jobs)) return 1;
+
+    const fs::path root(workDir);
+    std::ofstream results(root / "results.txt");
+    if (!results) {
+        std::cerr << "Warning: could not open results file" << std::endl;
+    }
+
+    printMetricsHeader(std::cout);
+    if (results) printMetricsHeader(results);
+
+    int missing = 0;
+    int failed = 0;
+    int malformed = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        std::ifstream in(resultPath(root, i));
+        if (!in) {
+            std::cerr << "Missing result for job " << i << " (" << jobs[i].label << ")" << std::endl;
+            ++missing;
+            continue;
+        }
+
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(in, line)) {
+            ++lineNo;
+            if (line.empty()) continue;
+            if (line[0] == '#') {
+                std::cerr << "Job " << i << " (" << jobs[i].label << "): " << line.substr(2) << std::endl;
+                if (line.compare(0, 8, "# failed") == 0) ++failed;
+                continue;
+            }
+
+            std::istringstream fields(line);
+            MetricsRow row;
+            std::string maie, psnr, ssim;
+            std::getline(fields, row.label, '\t');
+            std::getline(fields, maie, '\t');
+            std::getline(fields, psnr, '\t');
+            std::getline(fields, ssim, '\t');
+            std::getline(fields, row.note);
+            if (!parseMetric(maie, row.maie) || !parseMetric(psnr, row.psnr) || !parseMetric(ssim, row.ssim)) {
+                std::cerr << "Job " << i << " (" << jobs[i].label << "): skipping malformed row " << lineNo
+                          << " of " << resultPath(root, i).string() << std::endl;
+                ++malformed;
+                continue;
+            }
+
+            printMetricsRow(std::cout, row);
+            if (results) printMetricsRow(results, row);
+        }
+    }
+
+    if (missing > 0)
+        std::cerr << missing << " of " << jobs.size() << " job(s) have no result yet" << std::endl;
+    if (failed > 0)
+        std::cerr << failed << " of " << jobs.size() << " job(s) failed" << std::endl;
+    if (malformed > 0)
+        std::cerr << malformed << " malformed result row(s) skipped" << std::endl;
+    return missing > 0 || failed > 0 || malformed > 0 ? 1 : 0;
+}
@@ -60,34 +60,11 @@ bool computeSymmetricFlowTVL1(const cv::Mat& I0, const cv::Mat& I1, cv::Mat& vs)
     return true;
 }
 
-// Compute symmetric flow v_s between I0 and I1 using Farnebäck optical flow.
-// I0, I1 : input frames (CV_8UC3 or CV_8UC1), same size
+// Symmetric flow from a forward/backward Farnebäck pair on grayscale frames
+// g0, g1 : grayscale frames (CV_8UC1), same size
 // vs     : output symmetric flow field (CV_32FC2)
-// returns: true on success
-bool computeSymmetricFlowFarneback(const Mat& I0, const Mat& I1, Mat& vs)
+static void symmetricFlowFarnebackGray(const Mat& g0, const Mat& g1, Mat& vs)
 {
-    if (I0.empty() || I1.empty()) {
-        std::cerr << "Error: one or both input frames are empty.\n";
-        return false;
-    }
-
-    if (I0.size() != I1.size()) {
-        std::cerr << "Error: input frames must have the same size.\n";
-        return false;
-    }
-
-    // Convert to grayscale for optical flow
-    Mat g0, g1;
-    if (I0.channels() == 3)
-        cvtColor(I0, g0, COLOR_BGR2GRAY);
-    else
-        g0 = I0.clone();
-
-    if (I1.channels() == 3)
-        cvtColor(I1, g1, COLOR_BGR2GRAY);
-    else
-        g1 = I1.clone();
-
     Mat flow_f, flow_b;
 
     // Forward flow: I0 -> I1
@@ -129,9 +106,210 @@ bool computeSymmetricFlowFarneback(const Mat& I0, const Mat& I1, Mat& vs)
             ps[x] = 0.5f * (vf - vb);
         }
     }
+}
+
+// Compute symmetric flow v_s between I0 and I1 using Farnebäck optical flow.
+// I0, I1 : input frames (CV_8UC3 or CV_8UC1), same size
+// vs     : output symmetric flow field (CV_32FC2)
+// returns: true on success
+bool computeSymmetricFlowFarneback(const Mat& I0, const Mat& I1, Mat& vs)
+{
+    if (I0.empty() || I1.empty()) {
+        std::cerr << "Error: one or both input frames are empty.\n";
+        return false;
+    }
 
+    if (I0.size() != I1.size()) {
+        std::cerr << "Error: input frames must have the same size.\n";
+        return false;
+    }
+
+    // Convert to grayscale for optical flow
+    Mat g0, g1;
+    if (I0.channels() == 3)
+        cvtColor(I0, g0, COLOR_BGR2GRAY);
+    else
+        g0 = I0.clone();
+
+    if (I1.channels() == 3)
+        cvtColor(I1, g1, COLOR_BGR2GRAY);
+    else
+        g1 = I1.clone();
+
+    symmetricFlowFarnebackGray(g0, g1, vs);
+    return true;
+}
+
+// Farnebäck symmetric flow reusing precomputed grayscale frames
+// f0, f1 : features of I0 and I1, same size
+// vs     : output symmetric flow field (CV_32FC2)
+// returns: true on success
+bool computeSymmetricFlowFarneback(const FrameFeatures& f0, const FrameFeatures& f1, Mat& vs)
+{
+    if (f0.gray.size() != f1.gray.size()) {
+        std::cerr << "Error: input frames must have the same size.\n";
+        return false;
+    }
+
+    symmetricFlowFarnebackGray(f0.gray, f1.gray, vs);
     return true;
 }
+
+// One Gauss-Newton update of the symmetric data term at a single pyramid level.
+// Linearizing I1(x + v + dv) - I0(x - v - dv) ~ It + (grad I0 + grad I1) . dv
+// gives 2x2 normal equations per pixel, averaged over a winSize box window.
+// plane0, plane1 : [I, Ix, Iy] planes of I0 and I1 (CV_32FC3)
+// flow           : symmetric flow at this level, updated in place (CV_32FC2)
+static void symmetricFlowStep(const Mat& plane0, const Mat& plane1, Mat& flow, int winSize)
+{
+    // Damping for flat regions, in squared gray levels per pixel
+    const float kReg = 1.0f;
+    const Size sz = flow.size();
+
+    // Sampling positions along the trajectory through x at t = 0.5
+    Mat map0(sz, CV_32FC2), map1(sz, CV_32FC2);
+    parallel_for_(Range(0, sz.height), [&](const Range& r) {
+        for (int y = r.start; y < r.end; ++y) {
+            const Point2f* pv = flow.ptr<Point2f>(y);
+            Point2f* m0 = map0.ptr<Point2f>(y);
+            Point2f* m1 = map1.ptr<Point2f>(y);
+            for (int x = 0; x < sz.width; ++x) {
+                m0[x] = Point2f(x - pv[x].x, y - pv[x].y);
+                m1[x] = Point2f(x + pv[x].x, y + pv[x].y);
+            }
+        }
+    });
+
+    Mat w0, w1;
+    remap(plane0, w0, map0, noArray(), INTER_LINEAR, BORDER_REPLICATE);
+    remap(plane1, w1, map1, noArray(), INTER_LINEAR, BORDER_REPLICATE);
+
+    // Per-pixel structure tensor (Ixx, Ixy, Iyy) and right-hand side (IxIt, IyIt)
+    Mat tensor(sz, CV_32FC3), rhs(sz, CV_32FC2);
+    parallel_for_(Range(0, sz.height), [&](const Range& r) {
+        for (int y = r.start; y < r.end; ++y) {
+            const float* a = w0.ptr<float>(y);
+            const float* b = w1.ptr<float>(y);
+            float* t = tensor.ptr<float>(y);
+            float* h = rhs.ptr<float>(y);
+            for (int x = 0; x < sz.width; ++x) {
+                float it = b[3 * x] - a[3 * x];
+                float gx = a[3 * x + 1] + b[3 * x + 1];
+                float gy = a[3 * x + 2] + b[3 * x + 2];
+                t[3 * x]     = gx * gx;
+                t[3 * x + 1] = gx * gy;
+                t[3 * x + 2] = gy * gy;
+                h[2 * x]     = gx * it;
+                h[2 * x + 1] = gy * it;
+            }
+        }
+    });
+
+    boxFilter(tensor, tensor, -1, Size(winSize, winSize));
+    boxFilter(rhs, rhs, -1, Size(winSize, winSize));
+
+    // Solve (A + kReg * I) dv = -b; the damped tensor is always invertible
+    parallel_for_(Range(0, sz.height), [&](const Range& r) {
+        for (int y = r.start; y < r.end; ++y) {
+            const float* t = tensor.ptr<float>(y);
+            const float* h = rhs.ptr<float>(y);
+            Point2f* pv = flow.ptr<Point2f>(y);
+            for (int x = 0; x < sz.width; ++x) {
+                float a11 = t[3 * x] + kReg;
+                float a12 = t[3 * x + 1];
+                float a22 = t[3 * x + 2] + kReg;
+                float inv = 1.0f / (a11 * a22 - a12 * a12);
+                pv[x].x -= (a22 * h[2 * x] - a12 * h[2 * x + 1]) * inv;
+                pv[x].y -= (a11 * h[2 * x + 1] - a12 * h[2 * x]) * inv;
+            }
+        }
+    });
+}
+
+// Compute symmetric flow v_s between I0 and I1 directly at the midpoint.
+// Each pyramid level refines v so that I0(x - v) matches I1(x + v), which places
+// the flow on the intermediate-frame grid and costs about one directional solve.
+// I0, I1     : input frames (CV_8UC3 or CV_8UC1), same size
+// vs         : output symmetric flow field (CV_32FC2)
+// levels     : number of pyramid levels (coarsest level kept >= 16 px)
+// winSize    : box window for the local normal equations
+// iterations : Gauss-Newton updates per level
+// returns    : true on success
+bool computeSymmetricFlowMidpoint(const Mat& I0, const Mat& I1, Mat& vs,
+                                  int levels, int winSize, int iterations)
+{
+    if (I0.empty() || I1.empty()) {
+        std::cerr << "Error: one or both input frames are empty.\n";
+        return false;
+    }
+
+    if (I0.size() != I1.size()) {
+        std::cerr << "Error: input frames must have the same size.\n";
+        return false;
+    }
+
+    // At least one level, so the features always carry warp planes
+    levels = std::max(levels, 1);
+    return computeSymmetricFlowMidpoint(*computeFrameFeatures(I0, levels),
+                                        *computeFrameFeatures(I1, levels),
+                                        vs, winSize, iterations);
+}
+
+// Midpoint symmetric flow reusing precomputed pyramids and warp planes
+// f0, f1     : features of I0 and I1, same size
+// vs         : output symmetric flow field (CV_32FC2)
+// winSize    : box window for the local normal equations
+// iterations : Gauss-Newton updates per level
+// returns    : true on success
+bool computeSymmetricFlowMidpoint(const FrameFeatures& f0, const FrameFeatures& f1, Mat& vs,
+                                  int winSize, int iterations)
+{
+    if (f0.guide.size() != f1.guide.size()) {
+        std::cerr << "Error: input frames must have the same size.\n";
+        return false;
+    }
+
+    const int maxLevel = static_cast<int>(std::min(f0.warpPlanes.size(), f1.warpPlanes.size())) - 1;
+    if (maxLevel < 0) {
+        std::cerr << "Error: frame features were computed without a pyramid (levels <= 0).\n";
+        return false;
+    }
+
+    Mat flow;
+    for (int lvl = maxLevel; lvl >= 0; --lvl) {
+        const Size sz = f0.warpPlanes[lvl].size();
+
+        if (flow.empty()) {
+            flow = Mat::zeros(sz, CV_32FC2);
+        } else {
+            // Upsample the coarser estimate and rescale it to this level's pixels
+            const float sx = static_cast<float>(sz.width) / flow.cols;
+            const float sy = static_cast<float>(sz.height) / flow.rows;
+            Mat up;
+            resize(flow, up, sz, 0, 0, INTER_LINEAR);
+            parallel_for_(Range(0, up.rows), [&](const Range& r) {
+                for (int y = r.start; y < r.end; ++y) {
+                    Point2f* pv = up.ptr<Point2f>(y);
+                    for (int x = 0; x < up.cols; ++x) {
+                        pv[x].x *= sx;
+                        pv[x].y *= sy;
+                    }
+                }
+            });
+            flow = up;
+        }
+
+        for (int it = 0; it < iterations; ++it)
+            symmetricFlowStep(f0.warpPlanes[lvl], f1.warpPlanes[lvl], flow, winSize);
+
+        // Light smoothing before propagating to the next level
+        GaussianBlur(flow, flow, Size(5, 5), 1.0);
+    }
+
+    vs = flow;
+    return true;
+}
+
 // Compute Linear Optical Flow between I0 and I1 using Farnebäck optical flow(Just forward flow).
 // I0, I1 : input frames (CV_8UC3 or CV_8UC1), same size
 // vs     : output forward flow field (CV_32FC2)
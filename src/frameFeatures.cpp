@@ -0,0 +1,104 @@
+#include "frameFeatures.h"
+using namespace cv;
+
+// Stack intensity and its gradients into one CV_32FC3 plane so that a single
+// remap warps all three.
+// level : grayscale pyramid level (CV_32FC1)
+// plane : output [I, Ix, Iy] (CV_32FC3)
+void buildWarpPlane(const Mat& level, Mat& plane)
+{
+    Mat gx, gy;
+    Sobel(level, gx, CV_32F, 1, 0, 3, 1.0 / 8.0);
+    Sobel(level, gy, CV_32F, 0, 1, 3, 1.0 / 8.0);
+    merge(std::vector<Mat>{level, gx, gy}, plane);
+}
+
+// Compute grayscale, float guide, pyramid and warp planes for one frame
+// frame   : input frame (CV_8UC3 or CV_8UC1)
+// levels  : requested pyramid levels, <= 0 for grayscale and guide only
+// returns : immutable shared features
+std::shared_ptr<const FrameFeatures> computeFrameFeatures(const Mat& frame, int levels)
+{
+    CV_Assert(!frame.empty());
+
+    auto features = std::make_shared<FrameFeatures>();
+    if (frame.channels() == 3)
+        cvtColor(frame, features->gray, COLOR_BGR2GRAY);
+    else
+        features->gray = frame.clone();
+    features->gray.convertTo(features->guide, CV_32F);
+
+    // Flow backends that only need grayscale skip the pyramid
+    if (levels <= 0)
+        return features;
+
+    int maxLevel = levels - 1;
+    while (maxLevel > 0 && (std::min(frame.cols, frame.rows) >> maxLevel) < 16)
+        --maxLevel;
+
+    buildPyramid(features->guide, features->pyramid, maxLevel);
+    features->warpPlanes.resize(features->pyramid.size());
+    for (size_t lvl = 0; lvl < features->pyramid.size(); ++lvl)
+        buildWarpPlane(features->pyramid[lvl], features->warpPlanes[lvl]);
+
+    return features;
+}
+
+FrameFeatureCache::FrameFeatureCache(int levels, int usesPerFrame)
+    : levels_(levels), usesPerFrame_(usesPerFrame)
+{
+    CV_Assert(usesPerFrame > 0);
+}
+
+// Return features for frame `index`, computing them on the first request.
+// The entry is evicted once it has been handed out usesPerFrame times.
+// The map only holds a placeholder future while the features are computed, so
+// the lock is never held across computeFrameFeatures.
+std::shared_ptr<const FrameFeatures> FrameFeatureCache::acquire(int index, const Mat& frame)
+{
+    std::promise<std::shared_ptr<const FrameFeatures>> promise;
+    std::shared_future<std::shared_ptr<const FrameFeatures>> features;
+    bool owner = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = entries_.find(index);
+        if (it == entries_.end()) {
+            it = entries_.emplace(index, Entry{promise.get_future().share(), usesPerFrame_}).first;
+            ++computed_;
+            owner = true;
+        }
+
+        features = it->second.features;
+        if (--it->second.remainingUses == 0)
+            entries_.erase(it);
+    }
+
+    if (owner) {
+        try {
+            promise.set_value(computeFrameFeatures(frame, levels_));
+        } catch (...) {
+            // Waiters rethrow the same error; a later request after eviction retries
+            promise.set_exception(std::current_exception());
+        }
+    }
+    return features.get();
+}
+
+void FrameFeatureCache::evict(int index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(index);
+}
+
+size_t FrameFeatureCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t FrameFeatureCache::computed() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return computed_;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <opencv2/opencv.hpp>
+#include "syntheticSequence.h"
+#include <iostream>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+using namespace cv;
+using namespace std;
+
+static void printUsage()
+{
+    cerr << "usage: synthetic_sequence_generator [--size WxH|720p|1080p|4k|8k] [--motion translation|rotation|occlusion]\n"
+            "                                    [--magnitude M] [--seed S] [--frames N] [--out DIR]" << endl;
+}
+
+// Write a synthetic sequence in the eval_data / ground_truth layout read by optical_flow_interpolation:
+// frames frame10.png .. frame<9+N>.png and, for every consecutive pair, the true midpoint
+// frameAAiBB.png, symmetric flow flowAAiBB.flo and visibility visibleAAiBB.png
+// usage: synthetic_sequence_generator [--size WxH|720p|1080p|4k|8k] [--motion translation|rotation|occlusion]
+//                                     [--magnitude M] [--seed S] [--frames N] [--out DIR]
+//   --frames : frames to render, 2 (one pair, the default) to 90
+int main(int argc, char** argv) {
+
+    SyntheticParams params;
+    string outRoot = "data";
+    int frameCount = 2;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try {
+            if (arg == "--size" && hasValue) {
+                if (!parseSyntheticSize(argv[++i], params.size)) {
+                    cerr << "Invalid size " << argv[i] << endl;
+                    return 1;
+                }
+            } else if (arg == "--motion" && hasValue) {
+                if (!parseSyntheticMotion(argv[++i], params.motion)) {
+                    cerr << "Invalid motion " << argv[i] << endl;
+                    return 1;
+                }
+            } else if (arg == "--magnitude" && hasValue) {
+                params.magnitude = std::stof(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                params.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--frames" && hasValue) {
+                frameCount = std::stoi(argv[++i]);
+            } else if (arg == "--out" && hasValue) {
+                outRoot = argv[++i];
+            } else {
+                cerr << "Unknown argument " << arg << endl;
+                printUsage();
+                return 1;
+            }
+        } catch (const std::logic_error&) {
+            // std::invalid_argument or std::out_of_range from the numeric parsers
+            cerr << "Invalid value " << argv[i] << " for " << arg << endl;
+            printUsage();
+            return 1;
+        }
+    }
+    // Frame numbers stay two digits, the frameNN.png names --sequence reads
+    if (frameCount < 2 || frameCount > 90) {
+        cerr << "Invalid frame count " << frameCount << endl;
+        printUsage();
+        return 1;
+    }
+
+    string name = string("synthetic_") + syntheticMotionName(params.motion) + "_"
+                + to_string(params.size.width) + "x" + to_string(params.size.height)
+                + "_s" + to_string(params.seed);
+    filesystem::path evalDir = filesystem::path(outRoot) / "eval_data" / name;
+    filesystem::path gtDir = filesystem::path(outRoot) / "ground_truth" / name;
+
+    std::error_code ec;
+    filesystem::create_directories(evalDir, ec);
+    if (!ec) filesystem::create_directories(gtDir, ec);
+    if (ec) {
+        cerr << "Failed to create output directories under " << outRoot << ": " << ec.message() << endl;
+        return 1;
+    }
+
+    double renderMs = 0.0;
+    for (int k = 0; k + 1 < frameCount; ++k) {
+        SyntheticPair pair;
+        params.pairIndex = k;
+        TickMeter timer;
+        timer.start();
+        generateSyntheticPair(params, pair);
+        timer.stop();
+        renderMs += timer.getTimeMilli();
+
+        // I0 of pair k is I1 of pair k - 1, already written
+        const string n0 = to_string(10 + k), n1 = to_string(11 + k);
+        const string pairName = n0 + "i" + n1;
+        bool ok = (k > 0 || imwrite((evalDir / ("frame" + n0 + ".png")).string(), pair.I0))
+               && imwrite((evalDir / ("frame" + n1 + ".png")).string(), pair.I1)
+               && imwrite((gtDir / ("frame" + pairName + ".png")).string(), pair.mid)
+               && imwrite((gtDir / ("visible" + pairName + ".png")).string(), pair.visible)
+               && writeFlowFile((gtDir / ("flow" + pairName + ".flo")).string(), pair.flowMid);
+        if (!ok) {
+            cerr << "Failed to write " << name << " pair " << pairName << endl;
+            return 1;
+        }
+    }
+
+    cout << name << ": " << frameCount << " frames rendered in " << renderMs << " ms" << endl;
+    return 0;
+}
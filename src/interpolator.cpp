@@ -0,0 +1,168 @@
+#include "interpolator.h"
+#include "occlusionHandling.h"
+#include "spatialRegularization.h"
+#include <iostream>
+using namespace cv;
+
+// Session buffers, all sized in the constructor
+struct Interpolator::State {
+    InterpolatorConfig config;
+    Mat gray0, gray1;              // CV_8UC1 frames of interpolate(); gray1 is also stream scratch
+    Mat streamGray;                // CV_8UC1 previous streamed frame, swapped with gray1
+    Mat guide0;                    // CV_32FC1 regularization guide
+    Mat flowFwd, flowBwd;          // CV_32FC2 Farneback flows
+    Mat vsRaw;                     // CV_32FC2 symmetric flow before regularization
+    Mat vs;                        // CV_32FC2 symmetric flow
+    Mat mask;                      // CV_32FC1 consistency mask
+    std::vector<Mat> flowChannels; // split scratch for regularization
+    Mat streamFrames[2];           // CV_8UC3 ring of the last two streamed frames
+    int previousSlot = 0;          // slot of the previous streamed frame
+    bool hasPrevious = false;
+};
+
+Interpolator::Interpolator(const InterpolatorConfig& config)
+    : state_(std::make_unique<State>())
+{
+    CV_Assert(config.size.width > 0 && config.size.height > 0);
+
+    State& s = *state_;
+    s.config = config;
+    s.gray0.create(config.size, CV_8UC1);
+    s.gray1.create(config.size, CV_8UC1);
+    s.streamGray.create(config.size, CV_8UC1);
+    s.guide0.create(config.size, CV_32FC1);
+    s.flowFwd.create(config.size, CV_32FC2);
+    s.flowBwd.create(config.size, CV_32FC2);
+    s.vsRaw.create(config.size, CV_32FC2);
+    s.vs.create(config.size, CV_32FC2);
+    s.mask.create(config.size, CV_32FC1);
+    s.flowChannels.resize(2);
+    for (Mat& c : s.flowChannels)
+        c.create(config.size, CV_32FC1);
+    for (Mat& f : s.streamFrames)
+        f.create(config.size, CV_8UC3);
+
+    // Touch every page here so the buffers live on the constructing thread's NUMA node
+    for (Mat* m : { &s.gray0, &s.gray1, &s.streamGray, &s.guide0, &s.flowFwd, &s.flowBwd,
+                    &s.vsRaw, &s.vs, &s.mask, &s.flowChannels[0], &s.flowChannels[1],
+                    &s.streamFrames[0], &s.streamFrames[1] })
+        m->setTo(Scalar::all(0));
+}
+
+Interpolator::~Interpolator() = default;
+Interpolator::Interpolator(Interpolator&&) noexcept = default;
+Interpolator& Interpolator::operator=(Interpolator&&) noexcept = default;
+
+const InterpolatorConfig& Interpolator::config() const
+{
+    CV_Assert(state_);
+    return state_->config;
+}
+
+const Mat& Interpolator::flow() const
+{
+    CV_Assert(state_);
+    return state_->config.pipeline == InterpolationPipeline::Raw ? state_->vsRaw : state_->vs;
+}
+
+const Mat& Interpolator::rawFlow() const
+{
+    CV_Assert(state_);
+    return state_->vsRaw;
+}
+
+const Mat& Interpolator::occlusionMask() const
+{
+    CV_Assert(state_);
+    return state_->mask;
+}
+
+// Inputs must be CV_8UC3 frames at the session resolution
+static bool checkFrame(const Mat& frame, const Size& size)
+{
+    if (frame.type() != CV_8UC3 || frame.size() != size) {
+        std::cerr << "Error: frame must be CV_8UC3 of size " << size.width << "x" << size.height << ".\n";
+        return false;
+    }
+    return true;
+}
+
+bool Interpolator::interpolate(const Mat& I0, const Mat& I1, Mat& out)
+{
+    CV_Assert(state_);
+    State& s = *state_;
+    if (!checkFrame(I0, s.config.size) || !checkFrame(I1, s.config.size))
+        return false;
+
+    cvtColor(I0, s.gray0, COLOR_BGR2GRAY);
+    cvtColor(I1, s.gray1, COLOR_BGR2GRAY);
+    runPipeline(s.gray0, s.gray1, I0, I1, out);
+    return true;
+}
+
+bool Interpolator::interpolateNext(const Mat& frame, Mat& out)
+{
+    CV_Assert(state_);
+    State& s = *state_;
+    if (!checkFrame(frame, s.config.size))
+        return false;
+
+    // The caller may reuse its buffer, so the frame is copied once into the free ring
+    // slot; it then serves as I1 now and as I0 of the next pair without another copy
+    Mat& current = s.streamFrames[1 - s.previousSlot];
+    frame.copyTo(current);
+
+    if (!s.hasPrevious) {
+        cvtColor(current, s.streamGray, COLOR_BGR2GRAY);
+        s.previousSlot = 1 - s.previousSlot;
+        s.hasPrevious = true;
+        return false;
+    }
+
+    cvtColor(current, s.gray1, COLOR_BGR2GRAY);
+    runPipeline(s.streamGray, s.gray1, s.streamFrames[s.previousSlot], current, out);
+
+    // This frame is I0 of the next pair
+    std::swap(s.streamGray, s.gray1);
+    s.previousSlot = 1 - s.previousSlot;
+    return true;
+}
+
+void Interpolator::resetStream()
+{
+    CV_Assert(state_);
+    state_->hasPrevious = false;
+}
+
+// Flow, optional regularization and occlusion stages, then the warp into out
+void Interpolator::runPipeline(const Mat& gray0, const Mat& gray1, const Mat& I0, const Mat& I1, Mat& out)
+{
+    State& s = *state_;
+    const InterpolatorConfig& c = s.config;
+
+    // Forward/backward Farneback, same settings as computeSymmetricFlowFarneback
+    calcOpticalFlowFarneback(gray0, gray1, s.flowFwd, 0.5, 3, 15, 3, 5, 1.2, 0);
+    calcOpticalFlowFarneback(gray1, gray0, s.flowBwd, 0.5, 3, 15, 3, 5, 1.2, 0);
+
+    // v_s(x) = 0.5 * (v_f(x) - v_b(x))
+    for (int y = 0; y < s.vsRaw.rows; ++y) {
+        const Point2f* pf = s.flowFwd.ptr<Point2f>(y);
+        const Point2f* pb = s.flowBwd.ptr<Point2f>(y);
+        Point2f* ps = s.vsRaw.ptr<Point2f>(y);
+        for (int x = 0; x < s.vsRaw.cols; ++x)
+            ps[x] = 0.5f * (pf[x] - pb[x]);
+    }
+
+    if (c.pipeline == InterpolationPipeline::Raw) {
+        interpolateSymmetric(I0, I1, s.vsRaw, out, c.precision);
+        return;
+    }
+
+    // Regularize a copy so rawFlow() stays available
+    computeOcclusionMask(s.flowFwd, s.flowBwd, s.mask, c.occlusionThreshold);
+    s.vsRaw.copyTo(s.vs);
+    gray0.convertTo(s.guide0, CV_32F);
+    jointBilateralRegularization(s.guide0, s.vs, s.flowChannels,
+                                 c.regularizationDiameter, c.sigmaColor, c.sigmaSpace);
+    interpolateSymmetricWithOcclusion(I0, I1, s.vs, s.mask, out, c.precision, c.occlusionFallback);
+}
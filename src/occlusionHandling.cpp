@@ -29,10 +29,36 @@ Mat computeOcclusionMask(const Mat &flowFwd,
 
     // Pixels with difference below threshold 
     Mat mask = (diffMag < threshold);
-    mask.convertTo(mask, CV_32FC1); // convert to flaot or blending operations
+    mask.convertTo(mask, CV_32FC1, 1.0 / 255.0); // 0/255 -> 0/1 float for blending operations
     return mask;
 }
 
+// Same test fused into one pass, writing into a caller-owned mask
+// Preconditions: flowFwd, flowBwd CV_32FC2 of same size; threshold > 0
+// Postconditions: mask is CV_32FC1 (1.0 = visible, 0.0 = occluded), reused when already allocated
+void computeOcclusionMask(const Mat &flowFwd,
+                          const Mat &flowBwd,
+                          Mat &mask,
+                          float threshold) {
+    CV_Assert(flowFwd.type() == CV_32FC2 && flowBwd.type() == CV_32FC2);
+    CV_Assert(flowFwd.size() == flowBwd.size());
+
+    mask.create(flowFwd.size(), CV_32FC1);
+    const float thr2 = threshold * threshold;
+
+    for (int y = 0; y < mask.rows; ++y) {
+        const Point2f* pf = flowFwd.ptr<Point2f>(y);
+        const Point2f* pb = flowBwd.ptr<Point2f>(y);
+        float* pm = mask.ptr<float>(y);
+        for (int x = 0; x < mask.cols; ++x) {
+            // Consistent flows satisfy v_f(x) = -v_b(x)
+            float dx = pf[x].x + pb[x].x;
+            float dy = pf[x].y + pb[x].y;
+            pm[x] = (dx * dx + dy * dy < thr2) ? 1.0f : 0.0f;
+        }
+    }
+}
+
 // Compute occlusion mask by estimating forward/backward Farneback flows
 // Preconditions: I0, I1 non-empty, same size; threshold > 0
 // Postconditions: Returns CV_32FC1 mask (1.0 = visible, 0.0 = occluded); inputs unchanged
@@ -49,5 +75,16 @@ Mat computeOcclusionMaskFarneback(const Mat& I0, const Mat& I1, float threshold)
     calcOpticalFlowFarneback(g0, g1, flowFwd, 0.5, 3, 15, 3, 5, 1.2, 0);
     calcOpticalFlowFarneback(g1, g0, flowBwd, 0.5, 3, 15, 3, 5, 1.2, 0);
 
+    return computeOcclusionMask(flowFwd, flowBwd, threshold);
+}
+
+// Same as above, reusing the frames' precomputed grayscale images
+Mat computeOcclusionMaskFarneback(const FrameFeatures& f0, const FrameFeatures& f1, float threshold) {
+    CV_Assert(!f0.gray.empty() && f0.gray.size() == f1.gray.size());
+
+    Mat flowFwd, flowBwd;
+    calcOpticalFlowFarneback(f0.gray, f1.gray, flowFwd, 0.5, 3, 15, 3, 5, 1.2, 0);
+    calcOpticalFlowFarneback(f1.gray, f0.gray, flowBwd, 0.5, 3, 15, 3, 5, 1.2, 0);
+
     return computeOcclusionMask(flowFwd, flowBwd, threshold);
 }
\ No newline at end of file
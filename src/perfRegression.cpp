@@ -0,0 +1,309 @@
+#include <opencv2/opencv.hpp>
+#include "syntheticSequence.h"
+#include "computeSymmetricFlow.h"
+#include "spatialRegularization.h"
+#include "occlusionHandling.h"
+#include "warpUtils.h"
+#include "interpolator.h"
+#include "evaluation.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace cv;
+using namespace std;
+
+// Metrics are keyed "<W>x<H>.<motion>.<name>"; the suffix decides how a value is compared:
+//   _mpix : stage throughput in megapixels/s, higher is better
+//   _epe  : mean endpoint error against ground truth on visible pixels, lower is better
+//   _psnr : PSNR of the interpolated frame against the true midpoint, higher is better
+// Ratios between stages of one run are checked against the fixed limits in kRatioGates
+// instead, with or without a baseline. Other keys are reported but not compared.
+typedef map<string, double> Metrics;
+
+// Limits on ratios measured within one run; they hold on any host, unlike absolute throughput
+struct RatioGate {
+    const char* name;  // metric name after the "<W>x<H>.<motion>." prefix
+    double minimum;
+    double maximum;
+};
+
+static const RatioGate kRatioGates[] = {
+    { "warp_q8_speedup", 2.0, 1e9 },  // FixedQ8 warp at least twice as fast as the Float warp
+    { "slowmo4_cost_x", 0.0, 3.0 },   // four slow-motion outputs under 0.75 * 4 times one output
+};
+
+static bool endsWith(const string& s, const string& suffix)
+{
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Best wall time of `repeats` runs, in seconds; setup runs untimed before each run
+static double timeStage(int repeats, const function<void()>& setup, const function<void()>& stage)
+{
+    double best = 0.0;
+    for (int i = 0; i < repeats; ++i) {
+        if (setup) setup();
+        TickMeter timer;
+        timer.start();
+        stage();
+        timer.stop();
+        double seconds = timer.getTimeSec();
+        if (i == 0 || seconds < best) best = seconds;
+    }
+    return best;
+}
+
+// Time every pipeline stage on one synthetic pair and score flow and frame quality
+static void measurePair(const SyntheticParams& params, int repeats, Metrics& metrics)
+{
+    SyntheticPair pair;
+    generateSyntheticPair(params, pair);
+
+    const string prefix = to_string(params.size.width) + "x" + to_string(params.size.height)
+                        + "." + syntheticMotionName(params.motion) + ".";
+    const double mpix = params.size.area() / 1e6;
+    auto record = [&](const string& name, double seconds) {
+        metrics[prefix + name + "_mpix"] = seconds > 0.0 ? mpix / seconds : 0.0;
+    };
+
+    // Flow estimators
+    Mat vsFarneback, vsMidpoint;
+    record("farneback", timeStage(repeats, nullptr, [&] {
+        computeSymmetricFlowFarneback(pair.I0, pair.I1, vsFarneback);
+    }));
+    record("midpoint", timeStage(repeats, nullptr, [&] {
+        computeSymmetricFlowMidpoint(pair.I0, pair.I1, vsMidpoint);
+    }));
+    metrics[prefix + "farneback_epe"] = computeEndpointError(vsFarneback, pair.flowMid, pair.visible);
+    metrics[prefix + "midpoint_epe"] = computeEndpointError(vsMidpoint, pair.flowMid, pair.visible);
+
+    // Regularization of the Farneback flow, restored before each run
+    std::shared_ptr<const FrameFeatures> features = computeFrameFeatures(pair.I0, 0);
+    Mat vsRegularized;
+    vector<Mat> channels;
+    record("regularize", timeStage(repeats, [&] { vsFarneback.copyTo(vsRegularized); }, [&] {
+        jointBilateralRegularization(features->guide, vsRegularized, channels);
+    }));
+    metrics[prefix + "regularized_epe"] = computeEndpointError(vsRegularized, pair.flowMid, pair.visible);
+
+    // Consistency mask on the full ground-truth motions, so throughput is independent of estimator quality
+    Mat flowFwd = pair.flowTo1 - pair.flowTo0;
+    Mat flowBwd = -flowFwd;
+    Mat occMask;
+    record("mask", timeStage(repeats, nullptr, [&] {
+        computeOcclusionMask(flowFwd, flowBwd, occMask);
+    }));
+
+    // Warps on the regularized flow with the true visibility as mask
+    Mat visibleMask;
+    pair.visible.convertTo(visibleMask, CV_32FC1, 1.0 / 255.0);
+    Mat warped;
+    double warpFloat = timeStage(repeats, nullptr, [&] {
+        interpolateSymmetricWithOcclusion(pair.I0, pair.I1, vsRegularized, visibleMask, warped, WarpPrecision::Float);
+    });
+    double warpQ8 = timeStage(repeats, nullptr, [&] {
+        interpolateSymmetricWithOcclusion(pair.I0, pair.I1, vsRegularized, visibleMask, warped, WarpPrecision::FixedQ8);
+    });
+    record("warp_float", warpFloat);
+    record("warp_q8", warpQ8);
+    metrics[prefix + "warp_q8_speedup"] = warpQ8 > 0.0 ? warpFloat / warpQ8 : 0.0;
+    // Batched slow motion: k outputs from one pass against one output; throughput counts output pixels
+    vector<Mat> multiOut;
+    const vector<float> oneT = {0.5f};
+    const vector<float> fourTs = {0.2f, 0.4f, 0.6f, 0.8f};
+    double multi1 = timeStage(repeats, nullptr, [&] {
+        interpolateSymmetricMulti(pair.I0, pair.I1, vsRegularized, visibleMask, oneT, multiOut);
+    });
+    double multi4 = timeStage(repeats, nullptr, [&] {
+        interpolateSymmetricMulti(pair.I0, pair.I1, vsRegularized, visibleMask, fourTs, multiOut);
+    });
+    record("warp_multi1", multi1);
+    record("warp_multi4", multi4 / fourTs.size());
+    // Warp alone: every t samples its own bilinear taps, so this stays near k; reported, not compared
+    metrics[prefix + "warp_multi4_cost_x"] = multi1 > 0.0 ? multi4 / multi1 : 0.0;
+
+    // The same warp with the old zero-motion fallback instead of the span fill
+    record("warp_zero_motion", timeStage(repeats, nullptr, [&] {
+        interpolateSymmetricWithOcclusion(pair.I0, pair.I1, vsRegularized, visibleMask, warped,
+                                          WarpPrecision::Float, OcclusionFallback::ZeroMotion);
+    }));
+
+    // End to end through a session, as an application would run it
+    InterpolatorConfig config;
+    config.size = params.size;
+    config.pipeline = InterpolationPipeline::Regularized;
+    Interpolator session(config);
+    Mat out;
+    double pipeline = timeStage(repeats, nullptr, [&] {
+        session.interpolate(pair.I0, pair.I1, out);
+    });
+    record("pipeline", pipeline);
+    metrics[prefix + "pipeline_psnr"] = computePSNR(out, pair.mid);
+
+    // Slow motion: four outputs from the session's single flow solve and mask plus one batched
+    // warp, against one output from the session; running the pipeline per output would cost 4x
+    double slowmo4 = timeStage(repeats, nullptr, [&] {
+        session.interpolate(pair.I0, pair.I1, out);
+        interpolateSymmetricMulti(pair.I0, pair.I1, session.flow(), session.occlusionMask(), fourTs, multiOut);
+    });
+    metrics[prefix + "slowmo4_cost_x"] = pipeline > 0.0 ? slowmo4 / pipeline : 0.0;
+}
+
+static bool readMetrics(const string& path, Metrics& metrics)
+{
+    ifstream in(path);
+    if (!in) {
+        cerr << "Could not open baseline " << path << endl;
+        return false;
+    }
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream fields(line);
+        string key;
+        double value;
+        if (fields >> key >> value) metrics[key] = value;
+    }
+    return true;
+}
+
+static bool writeMetrics(const string& path, const Metrics& metrics)
+{
+    ofstream out(path);
+    if (!out) {
+        cerr << "Could not write baseline " << path << endl;
+        return false;
+    }
+    out << "# key value (perf_regression baseline)\n";
+    for (const auto& m : metrics)
+        out << m.first << " " << setprecision(6) << m.second << "\n";
+    return static_cast<bool>(out);
+}
+
+// Check the in-run ratios against kRatioGates; returns the number of violations
+static int checkRatios(const Metrics& current)
+{
+    int violations = 0;
+    for (const auto& m : current) {
+        for (const RatioGate& gate : kRatioGates) {
+            if (!endsWith(m.first, string(".") + gate.name)) continue;
+            if (m.second < gate.minimum || m.second > gate.maximum) {
+                cout << "REGRESSION " << m.first << ": " << m.second << " (allowed "
+                     << gate.minimum << " to " << gate.maximum << ")" << endl;
+                ++violations;
+            }
+        }
+    }
+    return violations;
+}
+
+// Compare against the baseline; returns the number of regressions
+// tolerance : allowed relative drop in throughput and relative rise in endpoint error
+static int compareMetrics(const Metrics& current, const Metrics& baseline, double tolerance)
+{
+    int regressions = 0;
+    for (const auto& b : baseline) {
+        auto it = current.find(b.first);
+        if (it == current.end()) continue;  // not measured in this run
+
+        const double base = b.second, value = it->second;
+        bool failed = false;
+        if (endsWith(b.first, "_mpix"))
+            failed = value < base * (1.0 - tolerance);
+        else if (endsWith(b.first, "_epe"))
+            failed = value > base * (1.0 + tolerance) + 0.05;
+        else if (endsWith(b.first, "_psnr"))
+            failed = value < base - 0.5;
+
+        if (failed) {
+            cout << "REGRESSION " << b.first << ": " << value << " (baseline " << base << ")" << endl;
+            ++regressions;
+        }
+    }
+    return regressions;
+}
+
+// usage: perf_regression [--sizes 1080p,4k,...] [--motions translation,rotation,occlusion]
+//                        [--magnitude M] [--repeats N] [--tolerance T]
+//                        [--baseline FILE [--record-missing]] [--write-baseline FILE]
+//   --record-missing : if the baseline file does not exist, write this run to it and pass
+//                      (first run on a machine, e.g. under ctest)
+// returns : 0 when nothing regressed, 1 on a regression or a ratio outside kRatioGates,
+//           2 on bad arguments or I/O errors
+int main(int argc, char** argv) {
+
+    string sizes = "1080p";
+    string motions = "translation,rotation,occlusion";
+    float magnitude = 16.0f;
+    int repeats = 3;
+    double tolerance = 0.15;
+    string baselinePath, writePath;
+    bool recordMissing = false;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try {
+            if (arg == "--sizes" && hasValue) sizes = argv[++i];
+            else if (arg == "--motions" && hasValue) motions = argv[++i];
+            else if (arg == "--magnitude" && hasValue) magnitude = stof(argv[++i]);
+            else if (arg == "--repeats" && hasValue) repeats = max(1, atoi(argv[++i]));
+            else if (arg == "--tolerance" && hasValue) tolerance = stod(argv[++i]);
+            else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+            else if (arg == "--write-baseline" && hasValue) writePath = argv[++i];
+            else if (arg == "--record-missing") recordMissing = true;
+            else {
+                cerr << "Unknown argument " << arg << endl;
+                return 2;
+            }
+        } catch (const std::logic_error&) {
+            cerr << "Invalid value " << argv[i] << " for " << arg << endl;
+            return 2;
+        }
+    }
+
+    auto splitList = [](const string& list) {
+        vector<string> items;
+        stringstream ss(list);
+        string item;
+        while (getline(ss, item, ',')) if (!item.empty()) items.push_back(item);
+        return items;
+    };
+
+    Metrics metrics;
+    for (const string& sizeText : splitList(sizes)) {
+        for (const string& motionText : splitList(motions)) {
+            SyntheticParams params;
+            params.magnitude = magnitude;
+            if (!parseSyntheticSize(sizeText, params.size) || !parseSyntheticMotion(motionText, params.motion)) {
+                cerr << "Invalid size or motion: " << sizeText << " " << motionText << endl;
+                return 2;
+            }
+            measurePair(params, repeats, metrics);
+        }
+    }
+
+    for (const auto& m : metrics)
+        cout << left << setw(48) << m.first << " " << fixed << setprecision(3) << m.second << endl;
+
+    if (!writePath.empty() && !writeMetrics(writePath, metrics)) return 2;
+
+    int regressions = checkRatios(metrics);
+
+    if (!baselinePath.empty() && recordMissing && !ifstream(baselinePath)) {
+        if (!writeMetrics(baselinePath, metrics)) return 2;
+        cout << "RECORDED: no baseline at " << baselinePath << ", this run is the new baseline" << endl;
+    } else if (!baselinePath.empty()) {
+        Metrics baseline;
+        if (!readMetrics(baselinePath, baseline)) return 2;
+        regressions += compareMetrics(metrics, baseline, tolerance);
+    }
+    cout << (regressions ? "FAILED: " : "PASSED: ") << regressions << " regression(s)" << endl;
+    return regressions ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "sequenceInterpolation.h"
+#include "computeSymmetricFlow.h"
+#include "spatialRegularization.h"
+#include "warpUtils.h"
+#include <iostream>
+using namespace cv;
+
+// Interpolate every consecutive pair, sharing per-frame features through the cache
+bool interpolateSequence(const std::vector<Mat>& frames, std::vector<Mat>& mids,
+                         FrameFeatureCache& cache)
+{
+    if (frames.size() < 2) {
+        std::cerr << "Error: a sequence needs at least two frames.\n";
+        return false;
+    }
+
+    const int last = static_cast<int>(frames.size()) - 1;
+    mids.resize(last);
+
+    Mat vs;
+    std::vector<Mat> channels;
+    for (int i = 0; i < last; ++i) {
+        std::shared_ptr<const FrameFeatures> f0 = cache.acquire(i, frames[i]);
+        std::shared_ptr<const FrameFeatures> f1 = cache.acquire(i + 1, frames[i + 1]);
+
+        // The first frame only takes part in one pair
+        if (i == 0) cache.evict(0);
+
+        if (!computeSymmetricFlowMidpoint(*f0, *f1, vs)) {
+            cache.evict(i + 1);
+            return false;
+        }
+        jointBilateralRegularization(f0->guide, vs, channels);
+        interpolateSymmetric(frames[i], frames[i + 1], vs, mids[i]);
+    }
+
+    // And neither does the last one
+    cache.evict(last);
+    return true;
+}
\ No newline at end of file
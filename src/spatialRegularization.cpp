@@ -17,18 +17,29 @@
 // Apply edge-aware smoothing to optical flow using joint bilateral filter algorithm
 void jointBilateralRegularization(const cv::Mat &guide, cv::Mat &flow,
                                   int d, double sigmaColor, double sigmaSpace) {
+    std::vector<cv::Mat> channels;
+    jointBilateralRegularization(guide, flow, channels, d, sigmaColor, sigmaSpace);
+}
+
+// Same, splitting the flow into caller-owned channel buffers that are reused across calls
+void jointBilateralRegularization(const cv::Mat &guide, cv::Mat &flow, std::vector<cv::Mat> &channels,
+                                  int d, double sigmaColor, double sigmaSpace) {
     CV_Assert(flow.type() == CV_32FC2);
 
-    std::vector<cv::Mat> channels;
     cv::split(flow, channels);
 
+    // A CV_32FC1 guide (e.g. FrameFeatures::guide) is used as is
     cv::Mat guideGray;
-    if (guide.channels() == 3) {
-        cv::cvtColor(guide, guideGray, cv::COLOR_BGR2GRAY);
+    if (guide.type() == CV_32FC1) {
+        guideGray = guide;
     } else {
-        guideGray = guide.clone();
+        if (guide.channels() == 3) {
+            cv::cvtColor(guide, guideGray, cv::COLOR_BGR2GRAY);
+        } else {
+            guideGray = guide.clone();
+        }
+        guideGray.convertTo(guideGray, CV_32F);
     }
-    guideGray.convertTo(guideGray, CV_32F);
 
     for (int i = 0; i < 2; ++i) {
         cv::ximgproc::jointBilateralFilter(
@@ -0,0 +1,244 @@
+#include "syntheticSequence.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+using namespace cv;
+
+namespace {
+
+// Band-limited procedural texture: a few oriented sinusoids per channel with
+// periods between 6 and 64 px. It can be evaluated exactly at any coordinate,
+// so every rendered frame and the ground-truth midpoint are alias-free.
+struct Texture {
+    static constexpr int kWaves = 6;
+    double fx[3][kWaves], fy[3][kWaves], phase[3][kWaves], amp[3][kWaves];
+
+    explicit Texture(uint32_t seed) {
+        // Raw mt19937 output is specified by the standard; distributions are not,
+        // so floats are derived by hand to keep textures identical across toolchains
+        std::mt19937 rng(seed);
+        auto uniform = [&rng](double lo, double hi) {
+            return lo + (hi - lo) * ((rng() >> 8) * (1.0 / 16777216.0));
+        };
+        for (int c = 0; c < 3; ++c) {
+            for (int k = 0; k < kWaves; ++k) {
+                double period = uniform(6.0, 64.0);
+                double angle = uniform(0.0, CV_PI);
+                fx[c][k] = 2.0 * CV_PI * std::cos(angle) / period;
+                fy[c][k] = 2.0 * CV_PI * std::sin(angle) / period;
+                phase[c][k] = uniform(0.0, 2.0 * CV_PI);
+                amp[c][k] = uniform(8.0, 18.0);
+            }
+        }
+    }
+
+    Vec3b at(double u, double v) const {
+        Vec3b out;
+        for (int c = 0; c < 3; ++c) {
+            double value = 128.0;
+            for (int k = 0; k < kWaves; ++k)
+                value += amp[c][k] * std::sin(fx[c][k] * u + fy[c][k] * v + phase[c][k]);
+            out[c] = saturate_cast<uchar>(value);
+        }
+        return out;
+    }
+};
+
+// Motion of one layer as the texture coordinate shown at pixel x at time offset s = t - 0.5
+struct LayerMotion {
+    SyntheticMotion type;
+    Point2d shift;   // total translation between t = 0 and t = 1
+    double angle;    // total rotation between t = 0 and t = 1 (radians)
+    Point2d centre;
+
+    Point2d textureCoord(Point2d x, double s) const {
+        if (type == SyntheticMotion::Rotation) {
+            double a = -s * angle;
+            Point2d d = x - centre;
+            return centre + Point2d(std::cos(a) * d.x - std::sin(a) * d.y,
+                                    std::sin(a) * d.x + std::cos(a) * d.y);
+        }
+        return x - s * shift;
+    }
+
+    // Position at time offset s of the texture point shown at pixel x at the midpoint
+    Point2d positionAt(Point2d x, double s) const {
+        if (type == SyntheticMotion::Rotation) {
+            double a = s * angle;
+            Point2d d = x - centre;
+            return centre + Point2d(std::cos(a) * d.x - std::sin(a) * d.y,
+                                    std::sin(a) * d.x + std::cos(a) * d.y);
+        }
+        return x + s * shift;
+    }
+};
+
+} // namespace
+
+// Render I0, mid and I1 and the exact flows to the midpoint
+// params : size, motion model, magnitude, seed and pair index within the sequence
+// pair   : output frames and ground truth
+void generateSyntheticPair(const SyntheticParams& params, SyntheticPair& pair)
+{
+    CV_Assert(params.size.width > 1 && params.size.height > 1 && params.pairIndex >= 0);
+
+    const Size size = params.size;
+    const Point2d centre((size.width - 1) * 0.5, (size.height - 1) * 0.5);
+    const Point2d direction(std::cos(CV_PI / 6.0), std::sin(CV_PI / 6.0));
+
+    const Texture background(params.seed);
+    const Texture foreground(params.seed + 1);
+
+    LayerMotion back{params.motion, direction * params.magnitude,
+                     params.magnitude * CV_PI / 180.0, centre};
+    LayerMotion front{SyntheticMotion::Translation, direction * params.magnitude, 0.0, centre};
+
+    // Occlusion: the square moves by +magnitude, the background by -magnitude / 2
+    const bool layered = params.motion == SyntheticMotion::Occlusion;
+    const double half = std::min(size.width, size.height) / 6.0;
+    if (layered) {
+        back.type = SyntheticMotion::Translation;
+        back.shift = direction * (-0.5 * params.magnitude);
+    }
+
+    auto inSquare = [&](Point2d x, double s) {
+        Point2d c = centre + s * front.shift;
+        return std::abs(x.x - c.x) < half && std::abs(x.y - c.y) < half;
+    };
+    auto inFrame = [&](Point2d p) {
+        return p.x >= 0.0 && p.y >= 0.0 && p.x <= size.width - 1.0 && p.y <= size.height - 1.0;
+    };
+
+    pair.I0.create(size, CV_8UC3);
+    pair.I1.create(size, CV_8UC3);
+    pair.mid.create(size, CV_8UC3);
+    pair.flowTo0.create(size, CV_32FC2);
+    pair.flowTo1.create(size, CV_32FC2);
+    pair.flowMid.create(size, CV_32FC2);
+    pair.visible.create(size, CV_8UC1);
+
+    // Time offsets are relative to the midpoint of pair 0; the motion is the same for
+    // every pair, only the occluding square's position depends on the pair
+    const double base = params.pairIndex;
+
+    parallel_for_(Range(0, size.height), [&](const Range& r) {
+        Mat* frames[3] = {&pair.I0, &pair.mid, &pair.I1};
+        const double offsets[3] = {base - 0.5, base, base + 0.5};
+
+        for (int y = r.start; y < r.end; ++y) {
+            Point2f* f0 = pair.flowTo0.ptr<Point2f>(y);
+            Point2f* f1 = pair.flowTo1.ptr<Point2f>(y);
+            Point2f* fm = pair.flowMid.ptr<Point2f>(y);
+            uchar* vis = pair.visible.ptr<uchar>(y);
+
+            for (int x = 0; x < size.width; ++x) {
+                const Point2d p(x, y);
+
+                for (int i = 0; i < 3; ++i) {
+                    const double s = offsets[i];
+                    Vec3b colour;
+                    if (layered && inSquare(p, s)) {
+                        Point2d u = front.textureCoord(p, s);
+                        colour = foreground.at(u.x, u.y);
+                    } else {
+                        Point2d u = back.textureCoord(p, s);
+                        colour = background.at(u.x, u.y);
+                    }
+                    frames[i]->ptr<Vec3b>(y)[x] = colour;
+                }
+
+                // Ground truth follows the layer visible at the midpoint
+                const bool onFront = layered && inSquare(p, base);
+                const LayerMotion& layer = onFront ? front : back;
+                Point2d p0 = layer.positionAt(p, -0.5);
+                Point2d p1 = layer.positionAt(p, 0.5);
+
+                f0[x] = Point2f(static_cast<float>(p0.x - x), static_cast<float>(p0.y - y));
+                f1[x] = Point2f(static_cast<float>(p1.x - x), static_cast<float>(p1.y - y));
+                fm[x] = 0.5f * (f1[x] - f0[x]);
+
+                bool seen = inFrame(p0) && inFrame(p1);
+                if (layered && !onFront)
+                    seen = seen && !inSquare(p0, base - 0.5) && !inSquare(p1, base + 0.5);
+                vis[x] = seen ? 255 : 0;
+            }
+        }
+    });
+}
+
+bool parseSyntheticSize(const std::string& text, Size& size)
+{
+    if (text == "720p")  { size = Size(1280, 720);  return true; }
+    if (text == "1080p") { size = Size(1920, 1080); return true; }
+    if (text == "4k")    { size = Size(3840, 2160); return true; }
+    if (text == "8k")    { size = Size(7680, 4320); return true; }
+
+    int w = 0, h = 0;
+    if (std::sscanf(text.c_str(), "%dx%d", &w, &h) == 2 && w > 1 && h > 1) {
+        size = Size(w, h);
+        return true;
+    }
+    return false;
+}
+
+bool parseSyntheticMotion(const std::string& text, SyntheticMotion& motion)
+{
+    if (text == "translation") { motion = SyntheticMotion::Translation; return true; }
+    if (text == "rotation")    { motion = SyntheticMotion::Rotation;    return true; }
+    if (text == "occlusion")   { motion = SyntheticMotion::Occlusion;   return true; }
+    return false;
+}
+
+const char* syntheticMotionName(SyntheticMotion motion)
+{
+    switch (motion) {
+    case SyntheticMotion::Translation: return "translation";
+    case SyntheticMotion::Rotation:    return "rotation";
+    case SyntheticMotion::Occlusion:   return "occlusion";
+    }
+    return "unknown";
+}
+
+// Mean endpoint error
+// flow, gt : CV_32FC2 of same size
+// mask     : optional CV_8UC1, pixels with 0 are skipped
+double computeEndpointError(const Mat& flow, const Mat& gt, const Mat& mask)
+{
+    CV_Assert(flow.type() == CV_32FC2 && gt.type() == CV_32FC2 && flow.size() == gt.size());
+    CV_Assert(mask.empty() || (mask.type() == CV_8UC1 && mask.size() == flow.size()));
+
+    double sum = 0.0;
+    size_t count = 0;
+    for (int y = 0; y < flow.rows; ++y) {
+        const Point2f* pf = flow.ptr<Point2f>(y);
+        const Point2f* pg = gt.ptr<Point2f>(y);
+        const uchar* pm = mask.empty() ? nullptr : mask.ptr<uchar>(y);
+        for (int x = 0; x < flow.cols; ++x) {
+            if (pm && !pm[x]) continue;
+            float dx = pf[x].x - pg[x].x;
+            float dy = pf[x].y - pg[x].y;
+            sum += std::sqrt(dx * dx + dy * dy);
+            ++count;
+        }
+    }
+    return count ? sum / count : 0.0;
+}
+
+// Middlebury .flo: "PIEH" tag, int32 width, int32 height, then interleaved (u, v) floats
+bool writeFlowFile(const std::string& path, const Mat& flow)
+{
+    CV_Assert(flow.type() == CV_32FC2);
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    const float tag = 202021.25f;
+    const int32_t w = flow.cols, h = flow.rows;
+    out.write(reinterpret_cast<const char*>(&tag), sizeof(tag));
+    out.write(reinterpret_cast<const char*>(&w), sizeof(w));
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    for (int y = 0; y < h; ++y)
+        out.write(reinterpret_cast<const char*>(flow.ptr<float>(y)), sizeof(float) * 2 * w);
+    return static_cast<bool>(out);
+}
\ No newline at end of file
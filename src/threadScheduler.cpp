@@ -0,0 +1,429 @@
+#include "threadScheduler.h"
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <cerrno>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace fs = std::filesystem;
+
+int CpuTopology::cpuCount() const {
+    int n = 0;
+    for (const auto& node : cpus) n += static_cast<int>(node.size());
+    return n;
+}
+
+// Parse a kernel cpulist
+// text    : comma separated CPUs and inclusive ranges, e.g. "0-3,8,10-11"
+// cpus    : output CPU numbers in list order
+// returns : false on malformed input
+bool parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    cpus.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) continue;
+        int first = 0, last = 0;
+        if (std::sscanf(item.c_str(), "%d-%d", &first, &last) == 2) {
+            if (first < 0 || last < first) return false;
+        } else if (std::sscanf(item.c_str(), "%d", &first) == 1 && first >= 0) {
+            last = first;
+        } else {
+            return false;
+        }
+        for (int c = first; c <= last; ++c) cpus.push_back(c);
+    }
+    return true;
+}
+
+// Group allowed CPUs by NUMA node
+CpuTopology detectCpuTopology() {
+    CpuTopology topology;
+
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    std::map<int, std::vector<int>> nodes;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator("/sys/devices/system/node", ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), ::isdigit))
+            continue;
+
+        std::ifstream in(entry.path() / "cpulist");
+        std::string text;
+        std::vector<int> cpus;
+        if (!std::getline(in, text) || !parseCpuList(text, cpus)) continue;
+
+        std::vector<int>& usable = nodes[std::stoi(name.substr(4))];
+        for (int c : cpus)
+            if (!haveMask || (c < CPU_SETSIZE && CPU_ISSET(c, &allowed))) usable.push_back(c);
+    }
+
+    for (auto& node : nodes) {
+        if (node.second.empty()) continue;  // memory-only node, or outside our mask
+        topology.nodeIds.push_back(node.first);
+        topology.cpus.push_back(node.second);
+    }
+
+    if (topology.cpus.empty() && haveMask) {
+        std::vector<int> cpus;
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &allowed)) cpus.push_back(c);
+        if (!cpus.empty()) {
+            topology.nodeIds.push_back(0);
+            topology.cpus.push_back(cpus);
+        }
+    }
+#endif
+
+    if (topology.cpus.empty()) {
+        std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+        for (size_t c = 0; c < cpus.size(); ++c) cpus[c] = static_cast<int>(c);
+        topology.nodeIds.push_back(0);
+        topology.cpus.push_back(cpus);
+    }
+    return topology;
+}
+
+// "0-3,8" style list for reports
+static std::string formatCpuList(const std::vector<int>& cpus) {
+    std::ostringstream out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (i > 0) out << ',';
+        out << cpus[i];
+        if (j > i) out << '-' << cpus[j];
+        i = j + 1;
+    }
+    return out.str();
+}
+
+// Bind the calling thread to cpus; threads it creates afterwards inherit the mask
+static bool pinCurrentThread(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        if (c < CPU_SETSIZE) CPU_SET(c, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+// perf node-loads / node-load-misses of a worker process and every thread it starts.
+// Opened by the parent before the worker runs; read after it exits, when the counts
+// of all its threads have been folded in.
+class NodeLoadCounters {
+public:
+    explicit NodeLoadCounters(pid_t pid) {
+#ifdef __linux__
+        loads_ = open(pid, PERF_COUNT_HW_CACHE_RESULT_ACCESS);
+        misses_ = open(pid, PERF_COUNT_HW_CACHE_RESULT_MISS);
+        if (loads_ >= 0 && misses_ >= 0) {
+            ioctl(loads_, PERF_EVENT_IOC_ENABLE, 0);
+            ioctl(misses_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#else
+        (void)pid;
+#endif
+    }
+
+    ~NodeLoadCounters() {
+#ifdef __linux__
+        if (loads_ >= 0) ::close(loads_);
+        if (misses_ >= 0) ::close(misses_);
+#endif
+    }
+
+    NodeLoadCounters(const NodeLoadCounters&) = delete;
+    NodeLoadCounters& operator=(const NodeLoadCounters&) = delete;
+
+    // returns : false when the kernel or CPU does not expose the events (or perf is restricted)
+    bool read(uint64_t& loads, uint64_t& misses) const {
+#ifdef __linux__
+        if (loads_ < 0 || misses_ < 0) return false;
+        return ::read(loads_, &loads, sizeof(loads)) == sizeof(loads) &&
+               ::read(misses_, &misses, sizeof(misses)) == sizeof(misses);
+#else
+        (void)loads;
+        (void)misses;
+        return false;
+#endif
+    }
+
+private:
+#ifdef __linux__
+    static int open(pid_t pid, uint64_t result) {
+        perf_event_attr attr = {};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_NODE | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, pid, -1, -1, 0));
+    }
+
+    int loads_ = -1;
+    int misses_ = -1;
+#endif
+};
+
+bool SchedulerReport::allCompleted() const {
+    for (const WorkerReport& r : workers)
+        if (!r.completed) return false;
+    return true;
+}
+
+ThreadScheduler::ThreadScheduler(const SchedulerConfig& config)
+    : topology_(detectCpuTopology()), pin_(config.pin) {
+    const int available = topology_.cpuCount();
+    budget_ = config.threadBudget > 0 ? std::min(config.threadBudget, available) : available;
+
+    // Take the budget node by node
+    std::vector<std::vector<int>> nodeCpus;
+    std::vector<int> nodeIds;
+    int taken = 0;
+    for (size_t n = 0; n < topology_.cpus.size() && taken < budget_; ++n) {
+        const int share = std::min(budget_ - taken, static_cast<int>(topology_.cpus[n].size()));
+        nodeCpus.emplace_back(topology_.cpus[n].begin(), topology_.cpus[n].begin() + share);
+        nodeIds.push_back(topology_.nodeIds[n]);
+        taken += share;
+    }
+
+    const int nodes = static_cast<int>(nodeCpus.size());
+    const int workers = config.workers > 0 ? std::min(config.workers, budget_) : nodes;
+
+    if (workers == nodes) {
+        // One worker per node, whatever the node sizes
+        for (int n = 0; n < nodes; ++n) {
+            WorkerPlacement placement;
+            placement.node = nodeIds[n];
+            placement.cpus = nodeCpus[n];
+            placements_.push_back(placement);
+        }
+        return;
+    }
+
+    // Otherwise contiguous ranges over the node-ordered budget, which stay within
+    // one node whenever the split allows it
+    std::vector<int> cpus, cpuNodes;
+    for (int n = 0; n < nodes; ++n) {
+        cpus.insert(cpus.end(), nodeCpus[n].begin(), nodeCpus[n].end());
+        cpuNodes.insert(cpuNodes.end(), nodeCpus[n].size(), nodeIds[n]);
+    }
+    placements_.resize(workers);
+    for (int w = 0; w < workers; ++w) {
+        const int begin = w * budget_ / workers;
+        const int end = (w + 1) * budget_ / workers;
+        placements_[w].node = cpuNodes[begin];
+        placements_[w].cpus.assign(cpus.begin() + begin, cpus.begin() + end);
+    }
+}
+
+// Threads of this process, from /proc/self/task; 1 where that is unavailable
+static int processThreadCount() {
+    int threads = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it("/proc/self/task", ec), end; !ec && it != end; it.increment(ec))
+        ++threads;
+    return threads > 0 ? threads : 1;
+}
+
+int ThreadScheduler::runWorker(int worker, const std::function<int(int worker)>& body) const {
+    const WorkerPlacement& placement = placements_[worker];
+    if (pin_ && !pinCurrentThread(placement.cpus))
+        std::cerr << "Warning: could not pin worker " << worker << " to CPUs "
+                  << formatCpuList(placement.cpus) << std::endl;
+
+    // This process's pool: exactly the worker's share, created on first use inside the mask
+    cv::setNumThreads(static_cast<int>(placement.cpus.size()));
+    return body(worker);
+}
+
+// Fork one pinned process per worker and wait for them
+// body    : called with the worker index in the worker process; a negative return
+//           is a failure and makes the worker exit with status 1
+// returns : wall and CPU time per worker, plus perf counters where available
+SchedulerReport ThreadScheduler::run(const std::function<int(int worker)>& body) {
+    // A forked child only gets the forking thread: a running OpenCV pool (or any other
+    // thread holding a lock) would be left half-copied in every worker. OpenCV has no
+    // query for its pool, so check that the parent has no thread besides this one.
+    CV_Assert(processThreadCount() == 1 && "ThreadScheduler::run must be called before any thread is started");
+
+    SchedulerReport report;
+    report.nodes = static_cast<int>(topology_.cpus.size());
+    report.threadBudget = budget_;
+    report.workers.resize(placements_.size());
+
+    struct Child {
+        pid_t pid = -1;
+        int resultFd = -1;
+        std::unique_ptr<NodeLoadCounters> counters;
+        std::chrono::steady_clock::time_point start;
+    };
+    std::vector<Child> children(placements_.size());
+
+    // Buffered output would otherwise be written once by every child
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    size_t running = 0;
+
+    for (size_t w = 0; w < placements_.size(); ++w) {
+        WorkerReport& r = report.workers[w];
+        r.node = placements_[w].node;
+        r.cpus = placements_[w].cpus;
+
+        int go[2], result[2];
+        if (::pipe(go) != 0) {
+            std::cerr << "Error: could not create pipes for worker " << w << std::endl;
+            continue;
+        }
+        if (::pipe(result) != 0) {
+            ::close(go[0]);
+            ::close(go[1]);
+            std::cerr << "Error: could not create pipes for worker " << w << std::endl;
+            continue;
+        }
+
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            // Worker: wait until the parent has attached the counters
+            ::close(go[1]);
+            ::close(result[0]);
+            char start;
+            if (::read(go[0], &start, 1) != 1) ::_exit(1);
+            ::close(go[0]);
+
+            const int units = runWorker(static_cast<int>(w), body);
+            const bool sent = ::write(result[1], &units, sizeof(units)) == sizeof(units);
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush(nullptr);
+            ::_exit(sent && units >= 0 ? 0 : 1);
+        }
+
+        ::close(go[0]);
+        ::close(result[1]);
+        if (pid < 0) {
+            std::cerr << "Error: could not start worker " << w << std::endl;
+            ::close(go[1]);
+            ::close(result[0]);
+            continue;
+        }
+
+        Child& child = children[w];
+        child.pid = pid;
+        child.resultFd = result[0];
+        child.counters = std::make_unique<NodeLoadCounters>(pid);
+        child.start = std::chrono::steady_clock::now();
+        if (::write(go[1], "g", 1) != 1)
+            std::cerr << "Warning: could not start worker " << w << std::endl;
+        ::close(go[1]);
+        ++running;
+    }
+
+    // Reap only our own children, in completion order so each worker's wall time is
+    // its own. The body may have started children of its own in this process's
+    // name, so wait4(-1) is not used; the stored PIDs are polled instead.
+    while (running > 0) {
+        bool reaped = false;
+        for (size_t w = 0; w < children.size(); ++w) {
+            Child& child = children[w];
+            if (child.pid < 0) continue;
+
+            int status = 0;
+            struct rusage usage;
+            const pid_t pid = ::wait4(child.pid, &status, WNOHANG, &usage);
+            if (pid == 0 || (pid < 0 && errno == EINTR)) continue;
+
+            WorkerReport& r = report.workers[w];
+            r.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - child.start).count();
+            if (pid == child.pid) {
+                r.cpuSeconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+                               usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+                int units = 0;
+                const bool received = ::read(child.resultFd, &units, sizeof(units)) == sizeof(units);
+                r.units = received ? units : 0;
+                r.completed = received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+                r.countersValid = child.counters->read(r.nodeLoads, r.remoteNodeLoads);
+            } else {
+                std::cerr << "Error: lost worker " << w << " (pid " << child.pid << ")" << std::endl;
+            }
+            ::close(child.resultFd);
+            child.pid = -1;
+            --running;
+            reaped = true;
+        }
+        if (!reaped) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    report.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    return report;
+}
+
+void printSchedulerReport(std::ostream& os, const SchedulerReport& report) {
+    std::ios state(nullptr);
+    state.copyfmt(os);
+    os << std::fixed << std::setprecision(1);
+
+    os << "scheduler: " << report.nodes << " NUMA node(s), budget " << report.threadBudget
+       << " CPU(s), " << report.workers.size() << " worker process(es)\n";
+
+    double cpuTotal = 0.0;
+    for (size_t w = 0; w < report.workers.size(); ++w) {
+        const WorkerReport& r = report.workers[w];
+        const double capacity = r.wallSeconds * r.cpus.size();
+        cpuTotal += r.cpuSeconds;
+
+        os << "  worker " << w << "  node " << r.node << "  cpus " << formatCpuList(r.cpus)
+           << "  units " << r.units << "  wall " << r.wallSeconds << " s  cpu " << r.cpuSeconds << " s  util "
+           << (capacity > 0.0 ? 100.0 * r.cpuSeconds / capacity : 0.0) << "%";
+        if (r.countersValid) {
+            os << "  node loads " << r.nodeLoads << "  remote "
+               << (r.nodeLoads ? 100.0 * r.remoteNodeLoads / r.nodeLoads : 0.0) << "%";
+        } else {
+            os << "  node loads n/a";
+        }
+        if (!r.completed) os << "  FAILED";
+        os << "\n";
+    }
+
+    const double capacity = report.wallSeconds * report.threadBudget;
+    os << "  total cpu " << cpuTotal << " s over " << report.wallSeconds
+       << " s wall, utilization " << (capacity > 0.0 ? 100.0 * cpuTotal / capacity : 0.0)
+       << "% of budget" << std::endl;
+
+    os.copyfmt(state);
+}
\ No newline at end of file
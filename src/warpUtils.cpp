@@ -1,4 +1,6 @@
 #include "warpUtils.h"
+#include <algorithm>
+#include <limits>
 
 // Bilinear sampling from RGB image at floating coordinates
 // Bilinear sample with bounds check (expects CV_8UC3)
@@ -34,17 +36,304 @@ bool sampleFrameBilinear(const cv::Mat& frame, float x, float y, cv::Vec3b& outP
     );
     return true;
 }
+
+// Fixed-point warp helpers
+// A BGR pixel is packed into one 64-bit word as three 16-bit lanes
+// (B | G << 16 | R << 32). Q8 bilinear weights always sum to 256, so every
+// lane of sum(p * w) stays <= 255 * 256 and no carry crosses into the next
+// lane: one integer multiply-add blends all three channels at once.
+static constexpr uint64_t kLaneMask  = 0x000000FF00FF00FFull;
+static constexpr uint64_t kLaneRound = 0x0000008000800080ull;
+
+static inline uint64_t packPixel(const uchar* p)
+{
+    return uint64_t(p[0]) | (uint64_t(p[1]) << 16) | (uint64_t(p[2]) << 32);
+}
+
+static inline void unpackPixel(uint64_t v, uchar* p)
+{
+    p[0] = static_cast<uchar>(v);
+    p[1] = static_cast<uchar>(v >> 16);
+    p[2] = static_cast<uchar>(v >> 32);
+}
+
+// Truncating per-lane average, matches static_cast<uchar>((a + b) * 0.5f)
+static inline uint64_t averagePacked(uint64_t a, uint64_t b)
+{
+    return ((a + b) >> 1) & kLaneMask;
+}
+
+// Q8 bilinear sample into a packed pixel (expects CV_8UC3)
+// returns : true if sample is valid, false if out of bounds
+static inline bool samplePackedQ8(const cv::Mat& frame, float x, float y, uint64_t& out)
+{
+    if (x < 0.0f || y < 0.0f || x >= frame.cols - 1.0f || y >= frame.rows - 1.0f)
+        return false;
+
+    int x0 = static_cast<int>(x);
+    int y0 = static_cast<int>(y);
+    // Fractions in Q8, 0..256 inclusive
+    uint32_t fx = static_cast<uint32_t>(cvRound((x - x0) * 256.0f));
+    uint32_t fy = static_cast<uint32_t>(cvRound((y - y0) * 256.0f));
+
+    // Corner weights sum to exactly 256 and are all non-negative
+    uint32_t w11 = (fx * fy + 128) >> 8;
+    uint32_t w01 = fx - w11;
+    uint32_t w10 = fy - w11;
+    uint32_t w00 = 256 - fx - fy + w11;
+
+    const uchar* r0 = frame.ptr<uchar>(y0)     + 3 * x0;
+    const uchar* r1 = frame.ptr<uchar>(y0 + 1) + 3 * x0;
+
+    uint64_t acc = packPixel(r0) * w00 + packPixel(r0 + 3) * w01
+                 + packPixel(r1) * w10 + packPixel(r1 + 3) * w11;
+    out = ((acc + kLaneRound) >> 8) & kLaneMask;
+    return true;
+}
+
+// Fixed-point bilinear sampling (expects CV_8UC3)
+// Same contract as sampleFrameBilinear; differs by at most kFixedWarpMaxError per channel
+bool sampleFrameBilinearFixed(const cv::Mat& frame, float x, float y, cv::Vec3b& outPixel)
+{
+    uint64_t v;
+    if (!samplePackedQ8(frame, x, y, v))
+        return false;
+    unpackPixel(v, outPixel.val);
+    return true;
+}
+
+// Occluded pixels [start, end) of one row, collected by the warp scan
+struct OccludedSpan {
+    int start;
+    int end;
+};
+
+// Append x to the row's spans, extending the last span when x follows it
+static inline void addOccluded(std::vector<OccludedSpan>& spans, int x)
+{
+    if (!spans.empty() && spans.back().end == x)
+        ++spans.back().end;
+    else
+        spans.push_back({x, x + 1});
+}
+
+// Same bounds rule as sampleFrameBilinear
+static inline bool inSampleRange(const cv::Mat& frame, float x, float y)
+{
+    return x >= 0.0f && y >= 0.0f && x < frame.cols - 1.0f && y < frame.rows - 1.0f;
+}
+
+// Squared distance between v and the symmetric flow at the pixel nearest to p
+static inline float flowMismatch(const cv::Mat& vs, cv::Point2f p, cv::Point2f v)
+{
+    int x = std::clamp(cvRound(p.x), 0, vs.cols - 1);
+    int y = std::clamp(cvRound(p.y), 0, vs.rows - 1);
+    cv::Point2f d = vs.at<cv::Point2f>(y, x) - v;
+    return d.x * d.x + d.y * d.y;
+}
+
+// Where to sample occluded pixel (x, y). The candidate background flows are those of the
+// visible pixels bounding its span; a landing point qualifies by how well the flow there
+// matches the candidate, i.e. how surely that background is visible on that side.
+// s0, s1  : trajectory scales, I0 at x - s0 * v and I1 at x + s1 * v (1, 1 at the midpoint)
+// side    : 0 to sample I0, 1 to sample I1, at `at`
+// returns : false when no candidate lands inside either frame
+static bool chooseFillSample(const cv::Mat& vs, const cv::Point2f* pv, const OccludedSpan& span,
+                             int x, int y, float s0, float s1, int& side, cv::Point2f& at)
+{
+    float best = std::numeric_limits<float>::max();
+    bool found = false;
+    const int neighbours[2] = { span.start - 1, span.end };
+
+    for (int n : neighbours) {
+        if (n < 0 || n >= vs.cols)
+            continue;
+        const cv::Point2f v = pv[n];
+        const cv::Point2f q[2] = { cv::Point2f(x - s0 * v.x, y - s0 * v.y),
+                                   cv::Point2f(x + s1 * v.x, y + s1 * v.y) };
+        for (int k = 0; k < 2; ++k) {
+            if (!inSampleRange(vs, q[k].x, q[k].y))
+                continue;
+            float mismatch = flowMismatch(vs, q[k], v);
+            if (mismatch < best) {
+                best = mismatch;
+                side = k;
+                at = q[k];
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+// Fill the occluded spans of row y
+// s0, s1 : trajectory scales as in chooseFillSample
+// a0, a1 : weights of the zero-motion blend, used where nothing lands inside a frame
+// po     : output row
+static void fillSpans(const cv::Mat& I0, const cv::Mat& I1, const cv::Mat& vs, int y,
+                      const std::vector<OccludedSpan>& spans,
+                      float s0, float s1, float a0, float a1, cv::Vec3b* po)
+{
+    const cv::Point2f* pv = vs.ptr<cv::Point2f>(y);
+    const cv::Vec3b* p0 = I0.ptr<cv::Vec3b>(y);
+    const cv::Vec3b* p1 = I1.ptr<cv::Vec3b>(y);
+
+    for (const OccludedSpan& span : spans) {
+        for (int x = span.start; x < span.end; ++x) {
+            int side = 0;
+            cv::Point2f at;
+            if (chooseFillSample(vs, pv, span, x, y, s0, s1, side, at)) {
+                sampleFrameBilinear(side == 0 ? I0 : I1, at.x, at.y, po[x]);
+                continue;
+            }
+
+            // The pixel's own flow if exactly one side is in frame, else zero motion
+            const cv::Point2f v = pv[x];
+            cv::Vec3b c0, c1;
+            bool valid0 = sampleFrameBilinear(I0, x - s0 * v.x, y - s0 * v.y, c0);
+            bool valid1 = sampleFrameBilinear(I1, x + s1 * v.x, y + s1 * v.y, c1);
+            if (valid0 && !valid1) {
+                po[x] = c0;
+            } else if (!valid0 && valid1) {
+                po[x] = c1;
+            } else {
+                po[x][0] = static_cast<uchar>(p0[x][0] * a0 + p1[x][0] * a1);
+                po[x][1] = static_cast<uchar>(p0[x][1] * a0 + p1[x][1] * a1);
+                po[x][2] = static_cast<uchar>(p0[x][2] * a0 + p1[x][2] * a1);
+            }
+        }
+    }
+}
+
+// Fixed-point counterpart of fillSpans at the midpoint
+static void fillSpansQ8(const cv::Mat& I0, const cv::Mat& I1, const cv::Mat& vs, int y,
+                        const std::vector<OccludedSpan>& spans, uchar* po)
+{
+    const cv::Point2f* pv = vs.ptr<cv::Point2f>(y);
+    const uchar* p0 = I0.ptr<uchar>(y);
+    const uchar* p1 = I1.ptr<uchar>(y);
+
+    for (const OccludedSpan& span : spans) {
+        for (int x = span.start; x < span.end; ++x) {
+            uint64_t out;
+            int side = 0;
+            cv::Point2f at;
+            if (chooseFillSample(vs, pv, span, x, y, 1.0f, 1.0f, side, at)) {
+                samplePackedQ8(side == 0 ? I0 : I1, at.x, at.y, out);
+                unpackPixel(out, po + 3 * x);
+                continue;
+            }
+
+            const cv::Point2f v = pv[x];
+            uint64_t c0, c1;
+            bool valid0 = samplePackedQ8(I0, x - v.x, y - v.y, c0);
+            bool valid1 = samplePackedQ8(I1, x + v.x, y + v.y, c1);
+            if (valid0 && !valid1)
+                out = c0;
+            else if (!valid0 && valid1)
+                out = c1;
+            else
+                out = averagePacked(packPixel(p0 + 3 * x), packPixel(p1 + 3 * x));
+            unpackPixel(out, po + 3 * x);
+        }
+    }
+}
+
+// Fixed-point counterpart of interpolateSymmetric
+static void interpolateSymmetricQ8(const cv::Mat& I0, const cv::Mat& I1,
+                                   const cv::Mat& vs, cv::Mat& I_mid)
+{
+    const int W = I0.cols;
+    const int H = I0.rows;
+
+    for (int y = 0; y < H; ++y) {
+        const cv::Point2f* pv = vs.ptr<cv::Point2f>(y);
+        const uchar* p0 = I0.ptr<uchar>(y);
+        const uchar* p1 = I1.ptr<uchar>(y);
+        uchar* po = I_mid.ptr<uchar>(y);
+
+        for (int x = 0; x < W; ++x) {
+            const cv::Point2f v = pv[x];
+            uint64_t c0, c1, out;
+            bool valid0 = samplePackedQ8(I0, x - v.x, y - v.y, c0);
+            bool valid1 = samplePackedQ8(I1, x + v.x, y + v.y, c1);
+
+            if (valid0 && valid1)
+                out = averagePacked(c0, c1);
+            else if (valid0)
+                out = c0;
+            else if (valid1)
+                out = c1;
+            else
+                out = averagePacked(packPixel(p0 + 3 * x), packPixel(p1 + 3 * x));
+
+            unpackPixel(out, po + 3 * x);
+        }
+    }
+}
+
+// Fixed-point counterpart of interpolateSymmetricWithOcclusion
+static void interpolateSymmetricWithOcclusionQ8(const cv::Mat& I0, const cv::Mat& I1,
+                                                const cv::Mat& vs, const cv::Mat& occMask,
+                                                cv::Mat& I_mid, OcclusionFallback fallback)
+{
+    const int W = I0.cols;
+    const int H = I0.rows;
+    std::vector<OccludedSpan> spans;
+
+    for (int y = 0; y < H; ++y) {
+        const cv::Point2f* pv = vs.ptr<cv::Point2f>(y);
+        const float* pm = occMask.ptr<float>(y);
+        const uchar* p0 = I0.ptr<uchar>(y);
+        const uchar* p1 = I1.ptr<uchar>(y);
+        uchar* po = I_mid.ptr<uchar>(y);
+        spans.clear();
+
+        for (int x = 0; x < W; ++x) {
+            if (fallback == OcclusionFallback::Fill && pm[x] <= 0.5f) {
+                addOccluded(spans, x);
+                continue;
+            }
+
+            const cv::Point2f v = pv[x];
+            uint64_t c0, c1, out;
+            bool valid0 = samplePackedQ8(I0, x - v.x, y - v.y, c0);
+            bool valid1 = samplePackedQ8(I1, x + v.x, y + v.y, c1);
+
+            if (valid0 && valid1 && pm[x] > 0.5f)
+                out = averagePacked(c0, c1);
+            else if (valid0 && !valid1)
+                out = c0;
+            else if (!valid0 && valid1)
+                out = c1;
+            else
+                out = averagePacked(packPixel(p0 + 3 * x), packPixel(p1 + 3 * x));
+
+            unpackPixel(out, po + 3 * x);
+        }
+
+        if (!spans.empty())
+            fillSpansQ8(I0, I1, vs, y, spans, po);
+    }
+}
+
 // Symmetric interpolation (no occlusion yet)
 // I0, I1  : input RGB frames (CV_8UC3)
 // vs      : symmetric flow field at middle time (CV_32FC2)
-// returns : interpolated midpoint frame
-cv::Mat interpolateSymmetric(const cv::Mat& I0, const cv::Mat& I1, const cv::Mat& vs)
+// I_mid   : output midpoint frame (CV_8UC3), reused when already allocated
+// precision : Float reference path or FixedQ8 integer path
+void interpolateSymmetric(const cv::Mat& I0, const cv::Mat& I1, const cv::Mat& vs,
+                          cv::Mat& I_mid, WarpPrecision precision)
 {
     CV_Assert(I0.size() == I1.size());
     CV_Assert(I0.type() == CV_8UC3 && I1.type() == CV_8UC3);
     CV_Assert(vs.size() == I0.size() && vs.type() == CV_32FC2);
 
-    cv::Mat I_mid(I0.size(), CV_8UC3);
+    I_mid.create(I0.size(), CV_8UC3);
+    if (precision == WarpPrecision::FixedQ8) {
+        interpolateSymmetricQ8(I0, I1, vs, I_mid);
+        return;
+    }
     const int W = I0.cols;
     const int H = I0.rows;
 
@@ -80,29 +369,60 @@ cv::Mat interpolateSymmetric(const cv::Mat& I0, const cv::Mat& I1, const cv::Mat
             I_mid.at<cv::Vec3b>(y, x) = out;
         }
     }
+}
+
+// Symmetric interpolation returning a newly allocated frame
+cv::Mat interpolateSymmetric(const cv::Mat& I0, const cv::Mat& I1, const cv::Mat& vs,
+                             WarpPrecision precision)
+{
+    cv::Mat I_mid;
+    interpolateSymmetric(I0, I1, vs, I_mid, precision);
     return I_mid;
 }
+
 // Symmetric interpolation regularazed and occlusion aware
 // I0, I1  : input RGB frames (CV_8UC3)
 // vs      : symmetric flow field at middle time (CV_32FC2)
-// returns : interpolated midpoint frame
+// occMask : consistency mask (CV_32FC1, 1.0 = consistent)
+// I_mid   : output midpoint frame (CV_8UC3), reused when already allocated
+// precision : Float reference path or FixedQ8 integer path
+// fallback  : Fill to fill occluded spans from the background, ZeroMotion for the old average
 
-cv::Mat interpolateSymmetricWithOcclusion(const cv::Mat& I0,
-                                          const cv::Mat& I1,
-                                          const cv::Mat& vs,
-                                          const cv::Mat& occMask)
+void interpolateSymmetricWithOcclusion(const cv::Mat& I0,
+                                       const cv::Mat& I1,
+                                       const cv::Mat& vs,
+                                       const cv::Mat& occMask,
+                                       cv::Mat& I_mid,
+                                       WarpPrecision precision,
+                                       OcclusionFallback fallback)
 {
     CV_Assert(I0.size() == I1.size());
     CV_Assert(I0.type() == CV_8UC3 && I1.type() == CV_8UC3);
     CV_Assert(vs.size() == I0.size() && vs.type() == CV_32FC2);
     CV_Assert(occMask.size() == I0.size());
 
-    cv::Mat I_mid(I0.size(), CV_8UC3);
+    I_mid.create(I0.size(), CV_8UC3);
+    if (precision == WarpPrecision::FixedQ8) {
+        CV_Assert(occMask.type() == CV_32FC1);
+        interpolateSymmetricWithOcclusionQ8(I0, I1, vs, occMask, I_mid, fallback);
+        return;
+    }
     const int W = I0.cols;
     const int H = I0.rows;
+    std::vector<OccludedSpan> spans;
 
     for (int y = 0; y < H; ++y) {
+        spans.clear();
         for (int x = 0; x < W; ++x) {
+            float w = occMask.at<float>(y, x); // 1.0 → consistent, 0.0 → inconsistent
+            w = std::clamp(w, 0.0f, 1.0f);
+
+            // Occluded pixels are left to the span fill below
+            if (fallback == OcclusionFallback::Fill && w <= 0.5f) {
+                addOccluded(spans, x);
+                continue;
+            }
+
             cv::Point2f v = vs.at<cv::Point2f>(y, x);
 
             float x0 = x - v.x;
@@ -114,9 +434,6 @@ cv::Mat interpolateSymmetricWithOcclusion(const cv::Mat& I0,
             bool valid0 = sampleFrameBilinear(I0, x0, y0, c0);
             bool valid1 = sampleFrameBilinear(I1, x1, y1, c1);
 
-            float w = occMask.at<float>(y, x); // 1.0 → consistent, 0.0 → inconsistent
-            w = std::clamp(w, 0.0f, 1.0f);
-
             cv::Vec3b out;
             if (valid0 && valid1) {
                 // Blend less when occluded/inconsistent
@@ -147,6 +464,113 @@ cv::Mat interpolateSymmetricWithOcclusion(const cv::Mat& I0,
             }
             I_mid.at<cv::Vec3b>(y, x) = out;
         }
+
+        if (!spans.empty())
+            fillSpans(I0, I1, vs, y, spans, 1.0f, 1.0f, 0.5f, 0.5f, I_mid.ptr<cv::Vec3b>(y));
     }
+}
+
+// Occlusion-aware interpolation returning a newly allocated frame
+cv::Mat interpolateSymmetricWithOcclusion(const cv::Mat& I0,
+                                          const cv::Mat& I1,
+                                          const cv::Mat& vs,
+                                          const cv::Mat& occMask,
+                                          WarpPrecision precision,
+                                          OcclusionFallback fallback)
+{
+    cv::Mat I_mid;
+    interpolateSymmetricWithOcclusion(I0, I1, vs, occMask, I_mid, precision, fallback);
     return I_mid;
+}
+
+// Batched symmetric interpolation at several times
+// I0, I1    : input RGB frames (CV_8UC3)
+// vs        : symmetric flow field at middle time (CV_32FC2); full motion is 2 * vs
+// occMask   : consistency mask (CV_32FC1, 1.0 = consistent) or empty
+// ts        : output times in (0, 1); t = 0.5 reproduces interpolateSymmetric(WithOcclusion)
+// outFrames : one CV_8UC3 frame per entry of ts, reused when already allocated
+void interpolateSymmetricMulti(const cv::Mat& I0,
+                               const cv::Mat& I1,
+                               const cv::Mat& vs,
+                               const cv::Mat& occMask,
+                               const std::vector<float>& ts,
+                               std::vector<cv::Mat>& outFrames)
+{
+    CV_Assert(I0.size() == I1.size());
+    CV_Assert(I0.type() == CV_8UC3 && I1.type() == CV_8UC3);
+    CV_Assert(vs.size() == I0.size() && vs.type() == CV_32FC2);
+    CV_Assert(occMask.empty() || (occMask.size() == I0.size() && occMask.type() == CV_32FC1));
+
+    const int K = static_cast<int>(ts.size());
+    outFrames.resize(K);
+    for (int k = 0; k < K; ++k) {
+        CV_Assert(ts[k] > 0.0f && ts[k] < 1.0f);
+        outFrames[k].create(I0.size(), CV_8UC3);
+    }
+    if (K == 0)
+        return;
+
+    // Displacement scales along the trajectory: x - 2t*v in I0, x + 2(1-t)*v in I1
+    std::vector<float> s0(K), s1(K), a0(K), a1(K);
+    for (int k = 0; k < K; ++k) {
+        s0[k] = 2.0f * ts[k];
+        s1[k] = 2.0f * (1.0f - ts[k]);
+        a0[k] = 1.0f - ts[k];
+        a1[k] = ts[k];
+    }
+
+    const int W = I0.cols;
+    const bool useMask = !occMask.empty();
+
+    cv::parallel_for_(cv::Range(0, I0.rows), [&](const cv::Range& r) {
+        std::vector<cv::Vec3b*> rows(K);
+        std::vector<OccludedSpan> spans;
+        for (int y = r.start; y < r.end; ++y) {
+            const cv::Point2f* pv = vs.ptr<cv::Point2f>(y);
+            const float* pm = useMask ? occMask.ptr<float>(y) : nullptr;
+            const cv::Vec3b* p0 = I0.ptr<cv::Vec3b>(y);
+            const cv::Vec3b* p1 = I1.ptr<cv::Vec3b>(y);
+            for (int k = 0; k < K; ++k)
+                rows[k] = outFrames[k].ptr<cv::Vec3b>(y);
+            spans.clear();
+
+            for (int x = 0; x < W; ++x) {
+                // Occluded pixels are collected once and filled for every t below
+                if (useMask && pm[x] <= 0.5f) {
+                    addOccluded(spans, x);
+                    continue;
+                }
+
+                const cv::Point2f v = pv[x];
+                const cv::Vec3b q0 = p0[x];
+                const cv::Vec3b q1 = p1[x];
+
+                for (int k = 0; k < K; ++k) {
+                    cv::Vec3b c0, c1;
+                    bool valid0 = sampleFrameBilinear(I0, x - s0[k] * v.x, y - s0[k] * v.y, c0);
+                    bool valid1 = sampleFrameBilinear(I1, x + s1[k] * v.x, y + s1[k] * v.y, c1);
+
+                    cv::Vec3b out;
+                    if (valid0 && valid1) {
+                        out[0] = static_cast<uchar>(c0[0] * a0[k] + c1[0] * a1[k]);
+                        out[1] = static_cast<uchar>(c0[1] * a0[k] + c1[1] * a1[k]);
+                        out[2] = static_cast<uchar>(c0[2] * a0[k] + c1[2] * a1[k]);
+                    } else if (valid0 && !valid1) {
+                        out = c0;
+                    } else if (!valid0 && valid1) {
+                        out = c1;
+                    } else {
+                        // Outside both frames: blend the sources at (x, y)
+                        out[0] = static_cast<uchar>(q0[0] * a0[k] + q1[0] * a1[k]);
+                        out[1] = static_cast<uchar>(q0[1] * a0[k] + q1[1] * a1[k]);
+                        out[2] = static_cast<uchar>(q0[2] * a0[k] + q1[2] * a1[k]);
+                    }
+                    rows[k][x] = out;
+                }
+            }
+
+            for (int k = 0; k < K && !spans.empty(); ++k)
+                fillSpans(I0, I1, vs, y, spans, s0[k], s1[k], a0[k], a1[k], rows[k]);
+        }
+    });
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+#!/bin/sh
+# Start several shard workers on one work directory, merge, and check the table.
+# usage: shardWorkers.sh <optical_flow_interpolation> <dataRoot> [workers] [jobs]
+set -u
+
+exe=$1
+data=$2
+workers=${3:-3}
+count=${4:-4}
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+# Same manifest as the README: dataset directories with a trailing slash
+ls -d "$data"/eval_data/*/ | head -n "$count" > "$work/jobs.txt"
+count=$(wc -l < "$work/jobs.txt")
+
+pids=""
+i=0
+while [ "$i" -lt "$workers" ]; do
+    "$exe" --shard-worker "$work/jobs.txt" "$work/shard" 60 &
+    pids="$pids $!"
+    i=$((i + 1))
+done
+
+status=0
+for pid in $pids; do
+    wait "$pid" || status=1
+done
+if [ "$status" -ne 0 ]; then
+    echo "a shard worker exited with an error"
+    exit 1
+fi
+
+if ! "$exe" --shard-merge "$work/jobs.txt" "$work/shard" > "$work/merged.txt"; then
+    cat "$work/merged.txt"
+    echo "merge reported missing or failed jobs"
+    exit 1
+fi
+cat "$work/merged.txt"
+
+results=$(ls "$work/shard/results" | grep -c '\.tsv$')
+if [ "$results" -ne "$count" ]; then
+    echo "expected $count results, found $results"
+    exit 1
+fi
+
+leases=$(ls "$work/shard/claims" | wc -l)
+if [ "$leases" -ne 0 ]; then
+    echo "$leases lease file(s) left behind"
+    exit 1
+fi
+
+# One raw row per job, labelled with the dataset name
+for dir in $(cat "$work/jobs.txt"); do
+    name=$(basename "$dir")
+    if ! grep -q "^$name " "$work/shard/results.txt"; then
+        echo "no row for $name"
+        exit 1
+    fi
+done
+exit 0
\ No newline at end of file
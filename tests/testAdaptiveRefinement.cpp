@@ -0,0 +1,113 @@
+#include <opencv2/opencv.hpp>
+#include "adaptiveRefinement.h"
+#include "syntheticSequence.h"
+#include <iostream>
+using namespace cv;
+
+// Mean |I1(x + vs) - I0(x - vs)| over roi, on grayscale frames
+static double meanResidual(const Mat& g0, const Mat& g1, const Mat& vs, const Rect& roi)
+{
+    Mat map0(vs.size(), CV_32FC2), map1(vs.size(), CV_32FC2);
+    for (int y = 0; y < vs.rows; ++y) {
+        const Point2f* pv = vs.ptr<Point2f>(y);
+        for (int x = 0; x < vs.cols; ++x) {
+            map0.at<Point2f>(y, x) = Point2f(x - pv[x].x, y - pv[x].y);
+            map1.at<Point2f>(y, x) = Point2f(x + pv[x].x, y + pv[x].y);
+        }
+    }
+    Mat w0, w1, residual;
+    remap(g0, w0, map0, noArray(), INTER_LINEAR, BORDER_REPLICATE);
+    remap(g1, w1, map1, noArray(), INTER_LINEAR, BORDER_REPLICATE);
+    absdiff(w0, w1, residual);
+    return mean(residual(roi))[0];
+}
+
+// computeSymmetricFlowAdaptive on a synthetic occlusion pair:
+// - the stats describe every block, confidences lie in [0, 1] and the refined count
+//   matches the refined map; thresholds that reject every block or none refine all or none
+// - blocks outside the queue are bit-identical to the cheap pass (disjoint block writes)
+// - refined blocks end with a lower warp residual than the cheap pass gave them
+int main() {
+    SyntheticParams synthetic;
+    synthetic.size = Size(320, 240);
+    synthetic.motion = SyntheticMotion::Occlusion;
+    synthetic.magnitude = 8.0f;
+    SyntheticPair pair;
+    generateSyntheticPair(synthetic, pair);
+
+    Mat g0, g1;
+    cvtColor(pair.I0, g0, COLOR_BGR2GRAY);
+    cvtColor(pair.I1, g1, COLOR_BGR2GRAY);
+
+    int failures = 0;
+    auto check = [&](bool ok, const char* what) {
+        if (!ok) {
+            std::cout << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    };
+
+    // Cheap pass only: no block can fail either test
+    AdaptiveRefinementParams none;
+    none.minConsistentFraction = 0.0f;
+    none.maxResidual = 1e9f;
+    Mat vsCheap, maskCheap;
+    AdaptiveRefinementStats statsNone;
+    check(computeSymmetricFlowAdaptive(pair.I0, pair.I1, vsCheap, maskCheap, none, &statsNone), "cheap pass runs");
+    check(statsNone.refinedBlocks == 0, "no block refined when every block passes");
+
+    // Every block refined: no block can reach a consistent fraction above 1
+    AdaptiveRefinementParams all;
+    all.minConsistentFraction = 2.0f;
+    Mat vsAll, maskAll;
+    AdaptiveRefinementStats statsAll;
+    check(computeSymmetricFlowAdaptive(pair.I0, pair.I1, vsAll, maskAll, all, &statsAll), "full refinement runs");
+    check(statsAll.refinedBlocks == statsAll.totalBlocks, "every block refined when every block fails");
+
+    // Default thresholds
+    AdaptiveRefinementParams params;
+    Mat vs, mask;
+    AdaptiveRefinementStats stats;
+    check(computeSymmetricFlowAdaptive(pair.I0, pair.I1, vs, mask, params, &stats), "adaptive pass runs");
+
+    const int bs = params.blockSize;
+    const int bx = (synthetic.size.width + bs - 1) / bs;
+    const int by = (synthetic.size.height + bs - 1) / bs;
+    check(stats.totalBlocks == bx * by, "one confidence per block");
+    check(stats.blockConfidence.size() == Size(bx, by) && stats.blockRefined.size() == Size(bx, by),
+          "block maps cover the block grid");
+    double minConfidence = 0.0, maxConfidence = 0.0;
+    minMaxLoc(stats.blockConfidence, &minConfidence, &maxConfidence);
+    check(minConfidence >= 0.0 && maxConfidence <= 1.0, "confidence in [0, 1]");
+    check(countNonZero(stats.blockRefined) == stats.refinedBlocks, "refined count matches the refined map");
+    check(stats.refinedBlocks > 0 && stats.refinedBlocks < stats.totalBlocks,
+          "occluding square refines some blocks but not all");
+
+    double cheapResidual = 0.0, refinedResidual = 0.0;
+    const Rect frame(0, 0, synthetic.size.width, synthetic.size.height);
+    for (int j = 0; j < by; ++j) {
+        for (int i = 0; i < bx; ++i) {
+            const Rect block = Rect(i * bs, j * bs, bs, bs) & frame;
+            const bool refined = stats.blockRefined.at<uchar>(j, i) != 0;
+
+            // A confident block never reaches the queue
+            if (stats.blockConfidence.at<float>(j, i) >= params.minConsistentFraction)
+                check(!refined, "confident block left alone");
+
+            if (!refined) {
+                check(norm(vs(block), vsCheap(block), NORM_INF) == 0.0 &&
+                      norm(mask(block), maskCheap(block), NORM_INF) == 0.0,
+                      "unrefined block identical to the cheap pass");
+            } else {
+                cheapResidual += meanResidual(g0, g1, vsCheap, block);
+                refinedResidual += meanResidual(g0, g1, vs, block);
+            }
+        }
+    }
+    check(refinedResidual < cheapResidual, "refinement lowers the residual of refined blocks");
+
+    std::cout << stats.refinedBlocks << " of " << stats.totalBlocks << " blocks refined, residual on refined blocks "
+              << cheapResidual / std::max(1, stats.refinedBlocks) << " -> "
+              << refinedResidual / std::max(1, stats.refinedBlocks) << std::endl;
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
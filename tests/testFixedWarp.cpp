@@ -0,0 +1,55 @@
+#include <opencv2/opencv.hpp>
+#include "warpUtils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+using namespace cv;
+
+// The FixedQ8 warp must stay within kFixedWarpMaxError levels of the Float path
+// and apply the same bounds rule, on single taps and on whole frames.
+int main() {
+    RNG rng(26);
+    int worst = 0;
+    int boundsMismatches = 0;
+
+    // Single taps, including coordinates outside the frame and on the last row/column
+    Mat frame(61, 83, CV_8UC3);
+    rng.fill(frame, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+    for (int i = 0; i < 2000000; ++i) {
+        float x = rng.uniform(-1.0f, frame.cols + 1.0f);
+        float y = rng.uniform(-1.0f, frame.rows + 1.0f);
+        Vec3b a, b;
+        bool validFloat = sampleFrameBilinear(frame, x, y, a);
+        bool validFixed = sampleFrameBilinearFixed(frame, x, y, b);
+        if (validFloat != validFixed) {
+            ++boundsMismatches;
+            continue;
+        }
+        if (!validFloat) continue;
+        for (int c = 0; c < 3; ++c)
+            worst = std::max(worst, std::abs(a[c] - b[c]));
+    }
+
+    // Whole frames under random flows, plain and occlusion-aware
+    for (int trial = 0; trial < 20; ++trial) {
+        Size size(rng.uniform(16, 200), rng.uniform(16, 120));
+        Mat I0(size, CV_8UC3), I1(size, CV_8UC3), vs(size, CV_32FC2), mask(size, CV_32FC1);
+        rng.fill(I0, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+        rng.fill(I1, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+        rng.fill(vs, RNG::UNIFORM, Scalar::all(-8), Scalar::all(8));
+        rng.fill(mask, RNG::UNIFORM, Scalar::all(0), Scalar::all(1));
+
+        Mat outFloat, outFixed;
+        interpolateSymmetric(I0, I1, vs, outFloat, WarpPrecision::Float);
+        interpolateSymmetric(I0, I1, vs, outFixed, WarpPrecision::FixedQ8);
+        worst = std::max(worst, static_cast<int>(norm(outFloat, outFixed, NORM_INF)));
+
+        interpolateSymmetricWithOcclusion(I0, I1, vs, mask, outFloat, WarpPrecision::Float);
+        interpolateSymmetricWithOcclusion(I0, I1, vs, mask, outFixed, WarpPrecision::FixedQ8);
+        worst = std::max(worst, static_cast<int>(norm(outFloat, outFixed, NORM_INF)));
+    }
+
+    std::cout << "max |FixedQ8 - Float| = " << worst << " (bound " << kFixedWarpMaxError << "), "
+              << boundsMismatches << " bounds mismatch(es)" << std::endl;
+    return worst <= kFixedWarpMaxError && boundsMismatches == 0 ? 0 : 1;
+}
\ No newline at end of file
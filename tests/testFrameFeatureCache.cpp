@@ -0,0 +1,63 @@
+#include <opencv2/opencv.hpp>
+#include "frameFeatures.h"
+#include "sequenceInterpolation.h"
+#include <iostream>
+#include <thread>
+using namespace cv;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Entries are shared until their second use, then evicted; a sequence of N frames
+// computes features N times instead of 2 (N - 1). Concurrent first requests for one
+// frame compute it once and share the result.
+int main() {
+    RNG rng(31);
+    std::vector<Mat> frames(6);
+    for (Mat& f : frames) {
+        f.create(48, 64, CV_8UC3);
+        rng.fill(f, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+    }
+
+    FrameFeatureCache cache(2, 2);
+    auto first = cache.acquire(0, frames[0]);
+    check(cache.size() == 1 && cache.computed() == 1, "first acquire computes and keeps the entry");
+
+    auto second = cache.acquire(0, frames[0]);
+    check(first.get() == second.get(), "second acquire returns the cached features");
+    check(cache.size() == 0 && cache.computed() == 1, "entry is evicted after the second use");
+    check(!second->warpPlanes.empty(), "evicted features stay alive through the shared_ptr");
+
+    cache.acquire(0, frames[0]);
+    check(cache.size() == 1 && cache.computed() == 2, "acquire after eviction recomputes");
+    cache.evict(0);
+    check(cache.size() == 0, "evict drops the entry");
+
+    FrameFeatureCache concurrentCache(2, 2);
+    std::shared_ptr<const FrameFeatures> fromA, fromB;
+    std::thread a([&] { fromA = concurrentCache.acquire(3, frames[3]); });
+    std::thread b([&] { fromB = concurrentCache.acquire(3, frames[3]); });
+    a.join();
+    b.join();
+    check(fromA && fromA.get() == fromB.get(), "concurrent acquires share one result");
+    check(concurrentCache.computed() == 1 && concurrentCache.size() == 0, "concurrent acquires compute once");
+
+    FrameFeatureCache sequenceCache(2, 2);
+    std::vector<Mat> mids;
+    check(interpolateSequence(frames, mids, sequenceCache), "sequence interpolation succeeds");
+    check(mids.size() == frames.size() - 1, "one midpoint per consecutive pair");
+    check(sequenceCache.computed() == frames.size(), "features are computed once per frame");
+    check(sequenceCache.size() == 0, "cache is empty after the sequence");
+    for (const Mat& mid : mids)
+        check(mid.type() == CV_8UC3 && mid.size() == frames[0].size(), "midpoint has the frame size and type");
+
+    std::cout << failures << " failure(s)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
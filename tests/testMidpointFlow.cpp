@@ -0,0 +1,45 @@
+#include <opencv2/opencv.hpp>
+#include "computeSymmetricFlow.h"
+#include "syntheticSequence.h"
+#include <iostream>
+using namespace cv;
+
+// computeSymmetricFlowMidpoint must recover the true symmetric flow of synthetic
+// translation and rotation pairs to within a fixed endpoint error on visible pixels.
+// Farneback's error on the same pair is printed for comparison.
+int main() {
+    struct Case {
+        SyntheticMotion motion;
+        float magnitude;
+        double maxEpe;  // px
+    };
+    const Case cases[] = {
+        { SyntheticMotion::Translation, 8.0f, 0.5 },
+        { SyntheticMotion::Rotation, 4.0f, 0.75 },
+    };
+
+    int failures = 0;
+    for (const Case& c : cases) {
+        SyntheticParams params;
+        params.size = Size(320, 240);
+        params.motion = c.motion;
+        params.magnitude = c.magnitude;
+        SyntheticPair pair;
+        generateSyntheticPair(params, pair);
+
+        Mat vsMidpoint, vsFarneback;
+        if (!computeSymmetricFlowMidpoint(pair.I0, pair.I1, vsMidpoint) ||
+            !computeSymmetricFlowFarneback(pair.I0, pair.I1, vsFarneback)) {
+            std::cout << syntheticMotionName(c.motion) << ": flow failed" << std::endl;
+            ++failures;
+            continue;
+        }
+
+        double epeMidpoint = computeEndpointError(vsMidpoint, pair.flowMid, pair.visible);
+        double epeFarneback = computeEndpointError(vsFarneback, pair.flowMid, pair.visible);
+        std::cout << syntheticMotionName(c.motion) << " " << c.magnitude << ": midpoint EPE " << epeMidpoint
+                  << " (limit " << c.maxEpe << "), Farneback EPE " << epeFarneback << std::endl;
+        if (!(epeMidpoint <= c.maxEpe)) ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include <opencv2/opencv.hpp>
+#include "threadScheduler.h"
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#endif
+using namespace cv;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// One worker on one node's CPUs: inside the worker, the affinity mask is exactly the
+// placement and OpenCV's pool has one thread per CPU; its unit count reaches the report.
+// A failing body marks the worker as not completed, and run() refuses to fork once
+// the process has another thread. No cv:: call may precede the first run().
+int main() {
+    const CpuTopology topology = detectCpuTopology();
+    SchedulerConfig config;
+    config.workers = 1;
+    config.threadBudget = std::min(2, static_cast<int>(topology.cpus.front().size()));
+    ThreadScheduler scheduler(config);
+    check(scheduler.placements().size() == 1, "one placement for one worker");
+    const std::vector<int> cpus = scheduler.placements().front().cpus;
+
+    const int kUnits = 7;
+    SchedulerReport report = scheduler.run([&](int worker) {
+        bool ok = worker == 0 && getNumThreads() == static_cast<int>(cpus.size());
+#ifdef __linux__
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        ok = ok && sched_getaffinity(0, sizeof(mask), &mask) == 0 &&
+             CPU_COUNT(&mask) == static_cast<int>(cpus.size());
+        for (int c : cpus)
+            ok = ok && CPU_ISSET(c, &mask);
+#endif
+        if (!ok) std::cerr << "worker affinity or pool size differs from its placement" << std::endl;
+        return ok ? kUnits : -1;
+    });
+    printSchedulerReport(std::cout, report);
+    check(report.workers.size() == 1 && report.allCompleted(), "pinned worker completes");
+    check(!report.workers.empty() && report.workers.front().units == kUnits, "unit count reaches the report");
+
+    SchedulerReport failed = scheduler.run([](int) { return -1; });
+    check(!failed.allCompleted(), "a negative return fails the worker");
+
+    // A live thread, as OpenCV's pool would be, must stop run() before it forks
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool release = false;
+    std::thread busy([&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&] { return release; });
+    });
+    bool refused = false;
+    try {
+        scheduler.run([](int) { return 0; });
+    } catch (const cv::Exception&) {
+        refused = true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    wake.notify_one();
+    busy.join();
+    check(refused, "run() refuses to fork a multi-threaded process");
+
+    std::cout << failures << " failure(s)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}